@@ -0,0 +1,206 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cfloat>
+#include <algorithm>
+#include <array>
+#include <SDL3/SDL.h>
+
+//pick the widest instruction set the compiler is targeting, msvc doesnt define __SSE2__ so check its macros too
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AABB_BATCH_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AABB_BATCH_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define AABB_BATCH_NEON
+#endif
+
+//how many boxes the kernel chews through per step, the arrays are always padded to a multiple of this
+#if defined(AABB_BATCH_AVX2)
+const int AABB_BATCH_WIDTH = 8;
+#else
+const int AABB_BATCH_WIDTH = 4;
+#endif
+
+//boxes stored as one array per edge instead of one rect each so the simd lanes can load them straight in
+//each box can also carry a collision category bit so whole groups can be skipped before testing
+struct AabbBatch {
+	std::vector<float> minX, minY, maxX, maxY;
+	//one bitset of box slots per category bit
+	std::array<std::vector<uint32_t>, 8> categorySlots;
+	int count;
+
+	AabbBatch() : count(0) {}
+
+	void clear() {
+		count = 0;
+		minX.clear();
+		minY.clear();
+		maxX.clear();
+		maxY.clear();
+		for (std::vector<uint32_t>& slots : categorySlots) {
+			slots.clear();
+		}
+	}
+	void push(const SDL_FRect& rect, uint8_t category = 0) {
+		//grow a whole step at a time and fill the padding with boxes that can never be hit
+		if (count % AABB_BATCH_WIDTH == 0) {
+			minX.resize(count + AABB_BATCH_WIDTH, FLT_MAX);
+			minY.resize(count + AABB_BATCH_WIDTH, FLT_MAX);
+			maxX.resize(count + AABB_BATCH_WIDTH, -FLT_MAX);
+			maxY.resize(count + AABB_BATCH_WIDTH, -FLT_MAX);
+			for (std::vector<uint32_t>& slots : categorySlots) {
+				slots.resize((count + AABB_BATCH_WIDTH + 31) / 32, 0);
+			}
+		}
+		count++;
+		set(count - 1, rect);
+		for (int bit = 0; bit < 8; bit++) {
+			if (category & (1u << bit)) {
+				categorySlots[bit][(count - 1) / 32] |= 1u << ((count - 1) % 32);
+			}
+		}
+	}
+	//bitset of every slot whose category is in the mask
+	void candidatesFor(uint8_t mask, std::vector<uint32_t>& candidates) const {
+		candidates.assign((paddedCount() + 31) / 32, 0);
+		for (int bit = 0; bit < 8; bit++) {
+			if (mask & (1u << bit)) {
+				for (size_t i = 0; i < candidates.size(); i++) {
+					candidates[i] |= categorySlots[bit][i];
+				}
+			}
+		}
+	}
+	void set(int i, const SDL_FRect& rect) {
+		minX[i] = rect.x;
+		minY[i] = rect.y;
+		maxX[i] = rect.x + rect.w;
+		maxY[i] = rect.y + rect.h;
+	}
+	SDL_FRect rect(int i) const {
+		return SDL_FRect{ minX[i], minY[i], maxX[i] - minX[i], maxY[i] - minY[i] };
+	}
+	int paddedCount() const { return static_cast<int>(minX.size()); }
+};
+
+//what came out of testing one rect against a batch, a bit per box plus the overlap rect for every box
+//the overlap is only meaningful where the bit is set and matches what SDL_GetRectIntersectionFloat would give
+struct AabbHits {
+	std::vector<uint32_t> mask;
+	std::vector<float> x, y, w, h;
+	//lanes the kernel actually compared, steps skipped for having no candidates dont count
+	int tested;
+
+	bool isHit(int i) const { return (mask[i / 32] >> (i % 32)) & 1u; }
+	void clearHit(int i) { mask[i / 32] &= ~(1u << (i % 32)); }
+	SDL_FRect overlap(int i) const { return SDL_FRect{ x[i], y[i], w[i], h[i] }; }
+};
+
+//tests one rect against every box in the batch, touching edges count as a hit just like SDL does
+//if candidates is given only those slots can hit and steps with no candidates in them are skipped entirely
+inline void intersectBatch(const SDL_FRect& rect, const AabbBatch& batch, AabbHits& hits,
+	const std::vector<uint32_t>* candidates = nullptr) {
+	const int padded = batch.paddedCount();
+	hits.mask.assign((padded + 31) / 32, 0);
+	hits.x.resize(padded);
+	hits.y.resize(padded);
+	hits.w.resize(padded);
+	hits.h.resize(padded);
+	hits.tested = 0;
+	//empty rects never hit anything in SDL either
+	if (rect.w < 0 || rect.h < 0) {
+		return;
+	}
+	const float aMinX = rect.x, aMinY = rect.y, aMaxX = rect.x + rect.w, aMaxY = rect.y + rect.h;
+	const uint32_t stepBits = (1u << AABB_BATCH_WIDTH) - 1;
+	const auto skipStep = [candidates, stepBits](int i) {
+		return candidates && !(((*candidates)[i / 32] >> (i % 32)) & stepBits);
+	};
+	int i = 0;
+#if defined(AABB_BATCH_AVX2)
+	const __m256 vMinX = _mm256_set1_ps(aMinX), vMinY = _mm256_set1_ps(aMinY);
+	const __m256 vMaxX = _mm256_set1_ps(aMaxX), vMaxY = _mm256_set1_ps(aMaxY);
+	const __m256 zero = _mm256_setzero_ps();
+	for (; i < padded; i += 8) {
+		if (skipStep(i)) {
+			continue;
+		}
+		hits.tested += AABB_BATCH_WIDTH;
+		const __m256 left = _mm256_max_ps(vMinX, _mm256_loadu_ps(&batch.minX[i]));
+		const __m256 top = _mm256_max_ps(vMinY, _mm256_loadu_ps(&batch.minY[i]));
+		const __m256 w = _mm256_sub_ps(_mm256_min_ps(vMaxX, _mm256_loadu_ps(&batch.maxX[i])), left);
+		const __m256 h = _mm256_sub_ps(_mm256_min_ps(vMaxY, _mm256_loadu_ps(&batch.maxY[i])), top);
+		const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(w, zero, _CMP_GE_OQ), _mm256_cmp_ps(h, zero, _CMP_GE_OQ));
+		_mm256_storeu_ps(&hits.x[i], left);
+		_mm256_storeu_ps(&hits.y[i], top);
+		_mm256_storeu_ps(&hits.w[i], w);
+		_mm256_storeu_ps(&hits.h[i], h);
+		hits.mask[i / 32] |= static_cast<uint32_t>(_mm256_movemask_ps(hit)) << (i % 32);
+	}
+#elif defined(AABB_BATCH_SSE2)
+	const __m128 vMinX = _mm_set1_ps(aMinX), vMinY = _mm_set1_ps(aMinY);
+	const __m128 vMaxX = _mm_set1_ps(aMaxX), vMaxY = _mm_set1_ps(aMaxY);
+	const __m128 zero = _mm_setzero_ps();
+	for (; i < padded; i += 4) {
+		if (skipStep(i)) {
+			continue;
+		}
+		hits.tested += AABB_BATCH_WIDTH;
+		const __m128 left = _mm_max_ps(vMinX, _mm_loadu_ps(&batch.minX[i]));
+		const __m128 top = _mm_max_ps(vMinY, _mm_loadu_ps(&batch.minY[i]));
+		const __m128 w = _mm_sub_ps(_mm_min_ps(vMaxX, _mm_loadu_ps(&batch.maxX[i])), left);
+		const __m128 h = _mm_sub_ps(_mm_min_ps(vMaxY, _mm_loadu_ps(&batch.maxY[i])), top);
+		const __m128 hit = _mm_and_ps(_mm_cmpge_ps(w, zero), _mm_cmpge_ps(h, zero));
+		_mm_storeu_ps(&hits.x[i], left);
+		_mm_storeu_ps(&hits.y[i], top);
+		_mm_storeu_ps(&hits.w[i], w);
+		_mm_storeu_ps(&hits.h[i], h);
+		hits.mask[i / 32] |= static_cast<uint32_t>(_mm_movemask_ps(hit)) << (i % 32);
+	}
+#elif defined(AABB_BATCH_NEON)
+	const float32x4_t vMinX = vdupq_n_f32(aMinX), vMinY = vdupq_n_f32(aMinY);
+	const float32x4_t vMaxX = vdupq_n_f32(aMaxX), vMaxY = vdupq_n_f32(aMaxY);
+	const float32x4_t zero = vdupq_n_f32(0);
+	for (; i < padded; i += 4) {
+		if (skipStep(i)) {
+			continue;
+		}
+		hits.tested += AABB_BATCH_WIDTH;
+		const float32x4_t left = vmaxq_f32(vMinX, vld1q_f32(&batch.minX[i]));
+		const float32x4_t top = vmaxq_f32(vMinY, vld1q_f32(&batch.minY[i]));
+		const float32x4_t w = vsubq_f32(vminq_f32(vMaxX, vld1q_f32(&batch.maxX[i])), left);
+		const float32x4_t h = vsubq_f32(vminq_f32(vMaxY, vld1q_f32(&batch.maxY[i])), top);
+		const uint32x4_t hit = vandq_u32(vcgeq_f32(w, zero), vcgeq_f32(h, zero));
+		vst1q_f32(&hits.x[i], left);
+		vst1q_f32(&hits.y[i], top);
+		vst1q_f32(&hits.w[i], w);
+		vst1q_f32(&hits.h[i], h);
+		//no movemask on neon so pull the top bit out of each lane
+		const uint32_t bits = (vgetq_lane_u32(hit, 0) & 1u) | (vgetq_lane_u32(hit, 1) & 2u) |
+			(vgetq_lane_u32(hit, 2) & 4u) | (vgetq_lane_u32(hit, 3) & 8u);
+		hits.mask[i / 32] |= bits << (i % 32);
+	}
+#endif
+	//plain version for anything without simd
+	hits.tested += padded - i;
+	for (; i < padded; i++) {
+		const float left = std::max(aMinX, batch.minX[i]);
+		const float top = std::max(aMinY, batch.minY[i]);
+		hits.x[i] = left;
+		hits.y[i] = top;
+		hits.w[i] = std::min(aMaxX, batch.maxX[i]) - left;
+		hits.h[i] = std::min(aMaxY, batch.maxY[i]) - top;
+		if (hits.w[i] >= 0 && hits.h[i] >= 0) {
+			hits.mask[i / 32] |= 1u << (i % 32);
+		}
+	}
+	if (candidates) {
+		for (size_t word = 0; word < hits.mask.size(); word++) {
+			hits.mask[word] &= (*candidates)[word];
+		}
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <SDL3/SDL.h>
+#include "AabbBatch.h"
+
+//little timing harnesses that get run from the command line instead of the game, results go to SDL_Log
+
+inline double secondsSince(Uint64 start) {
+	return static_cast<double>(SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+}
+
+//64 bit fnv-1a over the visible pixels of a surface, the padding at the end of each row is left out
+//so two frames hash the same exactly when every pixel matches
+inline uint64_t hashPixels(const SDL_Surface* surface) {
+	uint64_t hash = 14695981039346656037ull;
+	const size_t rowBytes = static_cast<size_t>(surface->w) * SDL_BYTESPERPIXEL(surface->format);
+	for (int y = 0; y < surface->h; y++) {
+		const Uint8* row = static_cast<const Uint8*>(surface->pixels) + static_cast<size_t>(y) * surface->pitch;
+		for (size_t i = 0; i < rowBytes; i++) {
+			hash = (hash ^ row[i]) * 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+//times the batch kernel against calling SDL_GetRectIntersectionFloat one box at a time
+//and checks the two agree on every box so a faster kernel cant quietly be a wrong one
+inline bool runAabbBenchmark(int boxCount, int iterations) {
+	SDL_srand(1234);
+	std::vector<SDL_FRect> rects;
+	AabbBatch batch;
+	for (int i = 0; i < boxCount; i++) {
+		//spread them over a level sized area with sizes around what bullets and characters use
+		SDL_FRect rect{
+			.x = static_cast<float>(SDL_rand(1600)),
+			.y = static_cast<float>(SDL_rand(320)),
+			.w = static_cast<float>(4 + SDL_rand(29)),
+			.h = static_cast<float>(4 + SDL_rand(29))
+		};
+		rects.push_back(rect);
+		batch.push(rect);
+	}
+	std::vector<SDL_FRect> queries;
+	for (int i = 0; i < iterations; i++) {
+		queries.push_back(SDL_FRect{
+			.x = static_cast<float>(SDL_rand(1600)),
+			.y = static_cast<float>(SDL_rand(320)),
+			.w = 12,
+			.h = 28
+		});
+	}
+
+	//keep the hit counts around so the compiler cant throw the loops away
+	int scalarHits = 0;
+	Uint64 start = SDL_GetPerformanceCounter();
+	for (const SDL_FRect& query : queries) {
+		for (const SDL_FRect& rect : rects) {
+			SDL_FRect overlap{ 0 };
+			if (SDL_GetRectIntersectionFloat(&query, &rect, &overlap)) {
+				scalarHits++;
+			}
+		}
+	}
+	const double scalarTime = secondsSince(start);
+
+	AabbHits hits;
+	int batchHits = 0;
+	start = SDL_GetPerformanceCounter();
+	for (const SDL_FRect& query : queries) {
+		intersectBatch(query, batch, hits);
+		for (uint32_t word : hits.mask) {
+			for (; word; word &= word - 1) {
+				batchHits++;
+			}
+		}
+	}
+	const double batchTime = secondsSince(start);
+
+	//compare box by box on a handful of the queries
+	int mismatches = 0;
+	for (int q = 0; q < iterations && q < 64; q++) {
+		intersectBatch(queries[q], batch, hits);
+		for (int i = 0; i < boxCount; i++) {
+			SDL_FRect overlap{ 0 };
+			const bool hit = SDL_GetRectIntersectionFloat(&queries[q], &rects[i], &overlap);
+			if (hit != hits.isHit(i) || (hit && (overlap.w != hits.w[i] || overlap.h != hits.h[i]))) {
+				mismatches++;
+			}
+		}
+	}
+
+	const double tests = static_cast<double>(boxCount) * iterations;
+	SDL_Log("aabb: %d boxes x %d queries, %d lanes", boxCount, iterations, AABB_BATCH_WIDTH);
+	SDL_Log("aabb: scalar SDL %.3f ms (%.2f ns/test, %d hits)", scalarTime * 1000, scalarTime * 1e9 / tests, scalarHits);
+	SDL_Log("aabb: batch      %.3f ms (%.2f ns/test, %d hits)", batchTime * 1000, batchTime * 1e9 / tests, batchHits);
+	SDL_Log("aabb: speedup %.2fx, %d mismatches", scalarTime / batchTime, mismatches);
+	return mismatches == 0 && scalarHits == batchHits;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <SDL3/SDL.h>
+#include "ContactEvents.h"
+
+//what we remember about a body touching a level collider from one frame to the next
+struct CachedContact {
+	//where the body was after it was last resolved against this collider
+	SDL_FRect bodyRect;
+	//frame it was last found touching and how many frames in a row that has been
+	uint32_t lastSeen;
+	uint32_t age;
+	//last frame the body was standing on it, 0 if it never has
+	uint32_t lastSupport;
+};
+
+inline bool sameRect(const SDL_FRect& a, const SDL_FRect& b) {
+	return a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h;
+}
+
+//body and level collider contacts kept across frames by pair id
+//the level never moves so a body in the exact same spot as last frame is touching exactly the same things
+struct ContactCache {
+	std::unordered_map<uint64_t, CachedContact> contacts;
+	//starts at 1 so a lastSupport of 0 can mean never
+	uint32_t frame;
+
+	ContactCache() : frame(1) {}
+
+	static uint64_t key(ObjectRef body, uint32_t collider) {
+		return (static_cast<uint64_t>(body.list) << 62) | (static_cast<uint64_t>(body.index) << 32) | collider;
+	}
+	CachedContact* find(uint64_t key) {
+		auto it = contacts.find(key);
+		return it != contacts.end() ? &it->second : nullptr;
+	}
+	//counts the contact as still there this frame
+	void keep(CachedContact& contact) {
+		if (contact.lastSeen != frame) {
+			contact.age = contact.lastSeen + 1 == frame ? contact.age + 1 : 1;
+			contact.lastSeen = frame;
+		}
+	}
+	//records a contact that was just resolved the full way
+	CachedContact& touch(uint64_t key, const SDL_FRect& bodyRect) {
+		CachedContact& contact = contacts.try_emplace(key, CachedContact{ bodyRect, 0, 0, 0 }).first->second;
+		contact.bodyRect = bodyRect;
+		keep(contact);
+		return contact;
+	}
+	//records the body standing on the collider, the sensor can find ground the body isnt quite touching yet
+	void support(uint64_t key, const SDL_FRect& bodyRect) {
+		touch(key, bodyRect).lastSupport = frame;
+	}
+	//drops anything that hasnt been touched for more than keepFrames and moves on to the next frame
+	void endFrame(uint32_t keepFrames) {
+		std::erase_if(contacts, [this, keepFrames](const auto& entry) {
+			return frame - entry.second.lastSeen > keepFrames;
+		});
+		frame++;
+	}
+	//drops every contact with a collider that is being removed or rebuilt so a new one in its slot starts fresh
+	void forgetCollider(uint32_t collider) {
+		std::erase_if(contacts, [collider](const auto& entry) {
+			return static_cast<uint32_t>(entry.first) == collider;
+		});
+	}
+	void clear() { contacts.clear(); }
+};
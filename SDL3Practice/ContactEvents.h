@@ -0,0 +1,33 @@
+#pragma once
+#include <cstdint>
+#include <SDL3/SDL.h>
+
+//the lists in the game state an object can live in
+enum class ObjectList : uint8_t {
+	level, characters, bullets
+};
+
+//finds an object by list and index instead of by pointer so it stays valid if a list grows
+struct ObjectRef {
+	ObjectList list;
+	uint32_t index;
+};
+
+//what gameplay needs to do about a contact once physics is finished
+//shotHitEnemy is a hitscan ray reaching an enemy, a is whoever fired and the overlap is just the hit point
+enum class ContactKind : uint8_t {
+	wake, bulletHitLevel, bulletHitEnemy, bulletHitPlayer, shotHitEnemy
+};
+
+//narrowphase only records these, the damage, animation and state changes get applied in one pass afterwards
+struct ContactEvent {
+	ContactKind kind;
+	ObjectRef a, b;
+	SDL_FRect overlap;
+};
+
+//a character or bullet found overlapping a character, initiators count through the characters then the bullets
+struct PairContact {
+	uint32_t initiator;
+	uint32_t target;
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <initializer_list>
+#include <SDL3/SDL.h>
+#include "RenderBackend.h"
+
+//debug shapes get collected over the frame and drawn all at once at the end
+//rects go out with one SDL_RenderFillRects and one SDL_RenderRects per colour and every line in one geometry call
+//so leaving the overlay on costs a handful of calls however many objects there are
+class DebugDraw {
+	struct Bucket {
+		SDL_Color color;
+		std::vector<SDL_FRect> fills, outlines;
+	};
+	//buckets stay around between frames so the same colours dont keep reallocating
+	std::vector<Bucket> buckets;
+	std::vector<SDL_Vertex> lineVertices;
+	std::vector<int> lineIndices;
+
+	Bucket& bucket(SDL_Color color) {
+		for (Bucket& b : buckets) {
+			if (b.color.r == color.r && b.color.g == color.g && b.color.b == color.b && b.color.a == color.a) {
+				return b;
+			}
+		}
+		buckets.push_back(Bucket{ color, {}, {} });
+		return buckets.back();
+	}
+
+public:
+	//how many render calls the last flush took
+	int callCount;
+
+	DebugDraw() : callCount(0) {}
+
+	void fillRect(const SDL_FRect& rect, SDL_Color color) { bucket(color).fills.push_back(rect); }
+	void rect(const SDL_FRect& rect, SDL_Color color) { bucket(color).outlines.push_back(rect); }
+	//lines are drawn as one pixel wide quads so they can all share one call whatever colour they are
+	void line(float x1, float y1, float x2, float y2, SDL_Color color) {
+		const float dx = x2 - x1, dy = y2 - y1;
+		const float len = std::sqrt(dx * dx + dy * dy);
+		if (len == 0) {
+			return;
+		}
+		//half a pixel out either side of the line
+		const float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+		const SDL_FColor c{ color.r / 255.0f, color.g / 255.0f, color.b / 255.0f, color.a / 255.0f };
+		const int first = static_cast<int>(lineVertices.size());
+		lineVertices.push_back(SDL_Vertex{ { x1 + nx, y1 + ny }, c, { 0, 0 } });
+		lineVertices.push_back(SDL_Vertex{ { x2 + nx, y2 + ny }, c, { 0, 0 } });
+		lineVertices.push_back(SDL_Vertex{ { x2 - nx, y2 - ny }, c, { 0, 0 } });
+		lineVertices.push_back(SDL_Vertex{ { x1 - nx, y1 - ny }, c, { 0, 0 } });
+		for (int corner : { 0, 1, 2, 0, 2, 3 }) {
+			lineIndices.push_back(first + corner);
+		}
+	}
+
+	//draws everything collected with blending on and clears it for next frame
+	void flush(RenderBackend& backend) {
+		callCount = 0;
+		backend.setDrawBlendMode(SDL_BLENDMODE_BLEND);
+		for (Bucket& b : buckets) {
+			if (b.fills.empty() && b.outlines.empty()) {
+				continue;
+			}
+			backend.setDrawColor(b.color.r, b.color.g, b.color.b, b.color.a);
+			if (!b.fills.empty()) {
+				backend.fillRects(b.fills.data(), static_cast<int>(b.fills.size()));
+				callCount++;
+			}
+			if (!b.outlines.empty()) {
+				backend.rects(b.outlines.data(), static_cast<int>(b.outlines.size()));
+				callCount++;
+			}
+			b.fills.clear();
+			b.outlines.clear();
+		}
+		if (!lineIndices.empty()) {
+			backend.geometry(nullptr, lineVertices.data(), static_cast<int>(lineVertices.size()),
+				lineIndices.data(), static_cast<int>(lineIndices.size()));
+			callCount++;
+		}
+		lineVertices.clear();
+		lineIndices.clear();
+		backend.setDrawBlendMode(SDL_BLENDMODE_NONE);
+	}
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cmath>
+#include <SDL3/SDL.h>
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+
+//one mark to put down in world space, only the part inside clip shows
+//erase wipes clip back to nothing instead, ie when the tile the marks were on goes away
+struct DecalStamp {
+	SDL_Texture* texture;
+	SDL_FRect src, dst, clip;
+	SDL_FColor color;
+	bool erase;
+};
+
+//marks that stay put for good, ie bullet holes, drawn into textures laid out on the same chunks as the tiles
+//each mark is drawn into its chunk once when its made and after that a chunk is one quad a frame
+//however many marks it holds, so unlike the tile chunks these are never thrown away since theyd be lost
+//the newest stamps of each chunk are also kept so the chunks can be drawn again if the render targets get lost
+//past that many the oldest are dropped, so after a reset only the newest marks come back but memory stays fixed
+class DecalLayer {
+	struct Chunk {
+		SDL_Texture* texture;
+		std::deque<DecalStamp> stamps;
+	};
+
+	int rows, cols, chunkCols;
+	float originX, originY, tileSize;
+	size_t historyLimit;
+	std::vector<Chunk> chunks;
+	//stamps made since the last draw, theyre put down then since only drawing touches the renderer
+	std::vector<DecalStamp> pending;
+	bool lost;
+
+	SDL_FRect chunkRect(int i) const {
+		return SDL_FRect{ originX + i * chunkCols * tileSize, originY, chunkCols * tileSize, rows * tileSize };
+	}
+
+	//draws one stamp into the current target, which is the chunk at chunkX chunkY
+	void apply(RenderBackend& backend, SpriteBatch& batch, const DecalStamp& stamp, float chunkX, float chunkY) {
+		const SDL_Rect clip{
+			.x = static_cast<int>(std::lround(stamp.clip.x - chunkX)),
+			.y = static_cast<int>(std::lround(stamp.clip.y - chunkY)),
+			.w = static_cast<int>(std::lround(stamp.clip.w)),
+			.h = static_cast<int>(std::lround(stamp.clip.h))
+		};
+		backend.setClip(&clip);
+		if (stamp.erase) {
+			backend.setDrawBlendMode(SDL_BLENDMODE_NONE);
+			backend.setDrawColor(0, 0, 0, 0);
+			backend.fillRect(SDL_FRect{ stamp.clip.x - chunkX, stamp.clip.y - chunkY, stamp.clip.w, stamp.clip.h });
+		}
+		else {
+			batch.draw(stamp.texture, stamp.src,
+				SDL_FRect{ stamp.dst.x - chunkX, stamp.dst.y - chunkY, stamp.dst.w, stamp.dst.h }, false, stamp.color);
+			batch.flush();
+		}
+		backend.setClip(nullptr);
+	}
+
+	//points drawing at a chunk, making its texture the first time anything lands on it
+	//false if the texture couldnt be made, then nothing should be drawn since it would land on the previous target
+	bool bind(RenderBackend& backend, Chunk& chunk, const SDL_FRect& rect) {
+		const bool created = !chunk.texture;
+		if (created) {
+			chunk.texture = SDL_CreateTexture(backend.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+				static_cast<int>(rect.w), static_cast<int>(rect.h));
+			if (!chunk.texture) {
+				return false;
+			}
+			SDL_SetTextureScaleMode(chunk.texture, SDL_SCALEMODE_NEAREST);
+			//marks get blended over each other inside the chunk so whats in it is already multiplied by its alpha
+			SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+		}
+		backend.setTarget(chunk.texture);
+		if (created || lost) {
+			backend.setDrawColor(0, 0, 0, 0);
+			backend.clear();
+		}
+		return true;
+	}
+
+public:
+	//how many stamps went into the chunks this frame
+	int stampsThisFrame;
+
+	DecalLayer() : rows(0), cols(0), chunkCols(1), originX(0), originY(0), tileSize(1), historyLimit(0), lost(false), stampsThisFrame(0) {}
+	DecalLayer(int rows, int cols, float originX, float originY, float tileSize, int chunkCols, size_t historyLimit)
+		: rows(rows), cols(cols), chunkCols(chunkCols), originX(originX), originY(originY), tileSize(tileSize),
+		historyLimit(historyLimit), chunks((cols + chunkCols - 1) / chunkCols, Chunk{ nullptr, {} }), lost(false), stampsThisFrame(0) {}
+
+	//queues src from texture over dst, cut down to clip, everything is in world space
+	void stamp(SDL_Texture* texture, const SDL_FRect& src, const SDL_FRect& dst, const SDL_FRect& clip, SDL_FColor color) {
+		if (texture) {
+			pending.push_back(DecalStamp{ texture, src, dst, clip, color, false });
+		}
+	}
+	//queues clearing every mark inside rect
+	void erase(const SDL_FRect& rect) {
+		pending.push_back(DecalStamp{ nullptr, SDL_FRect{ 0 }, rect, rect, SDL_FColor{ 0, 0, 0, 0 }, true });
+	}
+
+	//puts down anything stamped since last time then queues every chunk on screen that has marks on it
+	void draw(RenderBackend& backend, SpriteBatch& batch, RenderQueue& queue, RenderLayer layer, const SDL_FRect& viewport) {
+		stampsThisFrame = 0;
+		if (!pending.empty() || lost) {
+			//anything queued belongs to the screen so it has to go out before switching targets
+			batch.flush();
+			SDL_Texture* previous = backend.target();
+			//a chunk whose texture couldnt be made still keeps its stamps, everything gets drawn again next frame
+			bool retry = false;
+			for (int i = 0; i < static_cast<int>(chunks.size()); i++) {
+				Chunk& chunk = chunks[i];
+				const SDL_FRect rect = chunkRect(i);
+				//a lost chunk gets all its old stamps again before any new ones
+				bool bound = false;
+				if (lost && (chunk.texture || !chunk.stamps.empty())) {
+					bound = bind(backend, chunk, rect);
+					retry = retry || !bound;
+				}
+				if (bound) {
+					for (const DecalStamp& old : chunk.stamps) {
+						apply(backend, batch, old, rect.x, rect.y);
+					}
+				}
+				for (const DecalStamp& stamp : pending) {
+					SDL_FRect area;
+					if (!SDL_GetRectIntersectionFloat(&stamp.clip, &rect, &area)) {
+						continue;
+					}
+					//wiping a chunk that has nothing on it does nothing
+					if (stamp.erase && !chunk.texture && chunk.stamps.empty()) {
+						continue;
+					}
+					if (!bound) {
+						bound = bind(backend, chunk, rect);
+						retry = retry || !bound;
+					}
+					if (bound) {
+						apply(backend, batch, stamp, rect.x, rect.y);
+						stampsThisFrame++;
+					}
+					if (stamp.erase) {
+						//marks entirely inside what was wiped are gone for good so they dont need keeping
+						//and the wipe itself only needs keeping if it cut into marks that are still there
+						std::erase_if(chunk.stamps, [&](const DecalStamp& old) {
+							return old.clip.x >= stamp.clip.x && old.clip.y >= stamp.clip.y &&
+								old.clip.x + old.clip.w <= stamp.clip.x + stamp.clip.w &&
+								old.clip.y + old.clip.h <= stamp.clip.y + stamp.clip.h;
+						});
+						if (!chunk.stamps.empty()) {
+							chunk.stamps.push_back(stamp);
+						}
+					}
+					else {
+						chunk.stamps.push_back(stamp);
+					}
+					//an erase that ends up oldest only wiped marks that are already gone so it can go too
+					while (chunk.stamps.size() > historyLimit) {
+						chunk.stamps.pop_front();
+					}
+				}
+			}
+			backend.setTarget(previous);
+			pending.clear();
+			lost = retry;
+		}
+		for (int i = 0; i < static_cast<int>(chunks.size()); i++) {
+			const SDL_FRect rect = chunkRect(i);
+			if (chunks[i].texture && rect.x + rect.w > viewport.x && rect.x < viewport.x + viewport.w) {
+				queue.sprite(layer, chunks[i].texture, SDL_FRect{ 0, 0, rect.w, rect.h },
+					SDL_FRect{ rect.x - viewport.x, rect.y - viewport.y, rect.w, rect.h }, false);
+			}
+		}
+	}
+
+	//render target contents can get lost, ie when the device is reset, so every chunk gets its stamps again
+	void invalidate() { lost = true; }
+	//the textures go but the stamps are kept, so drawing again brings the newest marks back
+	void destroy(RenderBackend& backend) {
+		for (Chunk& chunk : chunks) {
+			backend.forgetTexture(chunk.texture);
+			SDL_DestroyTexture(chunk.texture);
+			chunk.texture = nullptr;
+		}
+		lost = true;
+	}
+};
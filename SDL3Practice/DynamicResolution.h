@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <SDL3/SDL.h>
+#include "RenderBackend.h"
+#include "SpriteBatch.h"
+
+//drops the resolution the scene is drawn at when drawing takes too long and brings it back up once theres room again
+//it goes by how long the drawing calls take on the cpu, what the gpu does after the commands are submitted isnt measured
+//the scene goes into the top left of a logical sized target with the render scale turned down
+//then that corner gets stretched over the screen in one nearest filtered copy
+//at full scale none of that happens and the scene draws straight to the screen
+class DynamicResolution {
+	int width, height;
+	SDL_Texture* target;
+	//seconds drawing a frame is allowed to take
+	float budget;
+	//draw time smoothed over the last few frames so one slow frame doesnt change anything
+	float smoothed;
+	float minScale, step;
+	//frames to wait after a change before judging again, it takes a few frames for a change to show up in the timing
+	int settleFrames;
+	//how many frames in a row have had plenty of room to spare
+	int calmFrames;
+
+public:
+	float scale;
+	bool enabled;
+
+	DynamicResolution() : width(0), height(0), target(nullptr), budget(1 / 60.0f), smoothed(0), minScale(0.5f), step(0.125f),
+		settleFrames(0), calmFrames(0), scale(1), enabled(false) {}
+	DynamicResolution(int width, int height, float budget, float minScale, float step)
+		: width(width), height(height), target(nullptr), budget(budget), smoothed(budget), minScale(minScale), step(step),
+		settleFrames(0), calmFrames(0), scale(1), enabled(true) {}
+
+	int scaledWidth() const { return static_cast<int>(std::lround(width * scale)); }
+	int scaledHeight() const { return static_cast<int>(std::lround(height * scale)); }
+
+	//feeds in how long drawing the last frame took and moves the scale a step if its been over or well under budget
+	void frameTime(float seconds) {
+		if (!enabled) {
+			scale = 1;
+			return;
+		}
+		smoothed += (seconds - smoothed) * 0.1f;
+		if (settleFrames > 0) {
+			settleFrames--;
+			return;
+		}
+		//going down happens as soon as were over, coming back needs a second of being well under
+		//so it doesnt flip back and forth right at the budget
+		calmFrames = smoothed < budget * 0.7f ? calmFrames + 1 : 0;
+		if (smoothed > budget && scale > minScale) {
+			scale = std::max(minScale, scale - step);
+			settleFrames = 30;
+		}
+		else if (calmFrames >= 60 && scale < 1) {
+			scale = std::min(1.0f, scale + step);
+			settleFrames = 30;
+			calmFrames = 0;
+		}
+	}
+
+	//points drawing at the reduced target, anything drawn until end comes out at the current scale
+	void begin(RenderBackend& backend) {
+		if (scale >= 1) {
+			return;
+		}
+		if (!target) {
+			target = SDL_CreateTexture(backend.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+			//without the target the scene just draws to the screen at full scale
+			if (!target) {
+				return;
+			}
+			SDL_SetTextureScaleMode(target, SDL_SCALEMODE_NEAREST);
+			SDL_SetTextureBlendMode(target, SDL_BLENDMODE_NONE);
+		}
+		backend.setTarget(target);
+		//scale is kept per target so this doesnt touch the screen or the chunk and backdrop targets
+		backend.setScale(scale, scale);
+	}
+
+	//stretches the part of the target that was drawn to over the whole screen
+	void end(RenderBackend& backend, SpriteBatch& batch) {
+		if (scale >= 1 || !target) {
+			return;
+		}
+		batch.flush();
+		backend.setTarget(nullptr);
+		batch.draw(target, SDL_FRect{ 0, 0, static_cast<float>(scaledWidth()), static_cast<float>(scaledHeight()) },
+			SDL_FRect{ 0, 0, static_cast<float>(width), static_cast<float>(height) }, false);
+		batch.flush();
+	}
+
+	void destroy(RenderBackend& backend) {
+		backend.forgetTexture(target);
+		SDL_DestroyTexture(target);
+		target = nullptr;
+	}
+};
@@ -1,6 +1,7 @@
 #pragma once
 #include <glm/glm.hpp>
 #include<vector>
+#include<cstdint>
 #include "Animation.h"
 #include <SDL3/SDL.h>
 
@@ -50,6 +51,28 @@ union ObjectData {
 enum class ObjectType {
 	player,level,enemy, bullet
 };
+const int OBJECT_TYPE_COUNT = 4;
+
+//every object type gets its own collision category bit
+constexpr uint8_t categoryOf(ObjectType type) {
+	return static_cast<uint8_t>(1u << static_cast<int>(type));
+}
+//the categories each type wants to be tested against, pairs that never do anything are left out
+//so they get thrown away before any rects are compared
+constexpr uint8_t defaultMaskOf(ObjectType type) {
+	switch (type) {
+	case ObjectType::player:
+		return categoryOf(ObjectType::level) | categoryOf(ObjectType::enemy);
+	case ObjectType::enemy:
+		return categoryOf(ObjectType::level) | categoryOf(ObjectType::enemy);
+	case ObjectType::bullet:
+		//bullets stop on the player as well, like they always have
+		return categoryOf(ObjectType::level) | categoryOf(ObjectType::enemy) | categoryOf(ObjectType::player);
+	default:
+		//level geometry never moves so it never starts a collision
+		return 0;
+	}
+}
 
 struct GameObject {
 	ObjectType type;
@@ -67,8 +90,14 @@ struct GameObject {
 	Timer flashTimer;
 	bool shouldFlash;
 	int spriteFrame;
+	//sleeping bodies skip physics until something wakes them, the timer is how long they need to be still first
+	bool sleeping;
+	Timer sleepTimer;
+	//which category this object is in and which categories it gets tested against
+	uint8_t collisionCategory;
+	uint8_t collisionMask;
 
-	GameObject() : data{ .level = LevelData() }, collider{ 0 },flashTimer(0.05f) {
+	GameObject() : data{ .level = LevelData() }, collider{ 0 },flashTimer(0.05f), sleepTimer(0.5f) {
 		data.level = LevelData();
 		type = ObjectType::level;
 		direction = 1;
@@ -80,5 +109,8 @@ struct GameObject {
 		grounded = false;
 		shouldFlash = false;
 		spriteFrame = 1;
+		sleeping = false;
+		collisionCategory = categoryOf(type);
+		collisionMask = defaultMaskOf(type);
 	}
 };
\ No newline at end of file
@@ -6,8 +6,31 @@
 #include<string>
 #include<array>
 #include<format>
+#include<bit>
+#include<cstring>
+#include<limits>
+#include<memory>
 
 #include "GameObject.h"
+#include "TileGrid.h"
+#include "AabbBatch.h"
+#include "Benchmark.h"
+#include "ContactEvents.h"
+#include "WorkerPool.h"
+#include "SweptAabb.h"
+#include "Raycast.h"
+#include "ContactCache.h"
+#include "PhysicsStats.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "TileChunks.h"
+#include "RenderBackend.h"
+#include "RenderQueue.h"
+#include "DebugDraw.h"
+#include "Parallax.h"
+#include "DynamicResolution.h"
+#include "SoftwareRenderBackend.h"
+#include "Decals.h"
 #include <glm/glm.hpp>
 //this sdl main is needed for the sdl to do its thing
 using namespace std;
@@ -16,9 +39,11 @@ using namespace glm;
 struct SDLState {
 	SDL_Window *window;
 	SDL_Renderer *renderer;
+	//where draw calls go, the real renderer or one that only counts them
+	RenderBackend *backend;
 	int width, height, logW, logH;
 	const bool *keys;
-	SDLState() : keys(SDL_GetKeyboardState(nullptr)){}
+	SDLState() : backend(nullptr), keys(SDL_GetKeyboardState(nullptr)){}
 };
 
 
@@ -28,6 +53,61 @@ const size_t LAYER_IDX_CHARACTERS = 1;
 const int MAP_ROWS = 5;
 const int MAP_COLS = 50;
 const int TILE_SIZE = 32;
+//how close the player has to be before an enemy starts chasing
+const float ENEMY_SIGHT_RANGE = 100;
+//how far a hitscan shot reaches and how long its tracer stays on screen
+const float HITSCAN_RANGE = 400;
+const float TRACER_TIME = 0.08f;
+//how many frames a body keeps its footing after the ground sensor stops finding anything
+//and how close the sensor still has to be to that ground, so walking off a ledge drops straight away
+const uint32_t GROUND_GRACE_FRAMES = 2;
+const float GROUND_GRACE_SLOP = 0.5f;
+//how much of the collision heatmap is left after each frame
+const float HEATMAP_DECAY = 0.9f;
+//below this many characters and bullets waking the workers costs more than the tests so the narrowphase stays on one thread
+const int NARROWPHASE_PARALLEL_MIN = 128;
+//static tile layers get baked in strips this many columns wide, each layer keeps about this much of them around
+const int TILE_CHUNK_COLS = 16;
+const size_t TILE_CHUNK_BUDGET_BYTES = 2 * 1024 * 1024;
+//panels can be shot out, ground cant, a bullet takes off as much as it does from an enemy
+const int PANEL_HEALTH = 30;
+const int BULLET_TILE_DAMAGE = 10;
+//vertex colour for the hit flash, colours past 1 get clamped by sdls software renderer and the software backend
+//so this takes green and blue out instead of pushing red up the way the old colour mod did
+const SDL_FColor HIT_FLASH_TINT{ 1.0f, 0.35f, 0.35f, 1.0f };
+//how long the velocity lines in debug mode are, in seconds of movement
+const float DEBUG_VELOCITY_SCALE = 0.25f;
+//how fast the nearest backdrop layer scrolls compared to the player, the further ones go a half and a quarter of that
+const float PARALLAX_SCROLL_FACTOR = 0.3f;
+//bullet impacts are stamped as a dark, mostly see through copy of the first frame of the hit sprite
+const SDL_FColor DECAL_TINT{ 0.15f, 0.12f, 0.1f, 0.8f };
+//stamps each decal chunk remembers for redrawing after its texture is lost, older marks dont come back
+const size_t DECAL_HISTORY_PER_CHUNK = 256;
+//time drawing a frame can take before the dynamic resolution drops and how far down and in what steps it can go
+const float FRAME_BUDGET = 1 / 60.0f;
+const float MIN_RESOLUTION_SCALE = 0.5f;
+const float RESOLUTION_STEP = 0.125f;
+
+//what each narrowphase worker writes to so they never share anything while they run
+struct NarrowphaseScratch {
+	vector<uint32_t> candidates;
+	AabbHits hits;
+	vector<PairContact> contacts;
+	int candidateCount;
+	int testCount;
+};
+
+//a shot fired in hitscan mode waiting for the characters to finish moving before its ray gets cast
+struct HitscanShot {
+	ObjectRef shooter;
+	vec2 origin, direction;
+};
+
+//the line left behind by a hitscan shot, its only for show
+struct Tracer {
+	vec2 start, end;
+	Timer life;
+};
 
 struct GameState {
 	//ccreating an array of vectors of game objects as vectors allow some flexibility but arrays will be constant
@@ -35,10 +115,50 @@ struct GameState {
 	vector<GameObject> backgroundTiles;
 	vector<GameObject> foregroundTiles;
 	vector<GameObject> bullets;
+	//solid tiles merged into bigger rectangles at load, only used for collision the tiles in the level layer are for drawing
+	vector<GameObject> levelColliders;
+	//maps each map cell to the level collider covering it so collisions only look at nearby colliders
+	TileGrid levelGrid;
+	//map each cell to the tile drawn there in layers[LAYER_IDX_LEVEL], backgroundTiles and foregroundTiles
+	//so drawing can go straight to the columns on screen
+	TileGrid levelTileGrid, backgroundTileGrid, foregroundTileGrid;
+	//the same three layers baked into textures a chunk at a time
+	TileChunkCache levelChunks, backgroundChunks, foregroundChunks;
+	//bullet marks on the level tiles, chunked the same as the tiles
+	DecalLayer decals;
+	//health of each destructible level tile, -1 for empty cells and tiles that cant be destroyed
+	TileGrid tileHealth;
+	//slots in layers[LAYER_IDX_LEVEL] and levelColliders left behind by removed tiles, reused before the lists grow
+	vector<int> freeLevelTiles, freeLevelColliders;
+	//world space collider of every character packed for the batch kernel, slot i is layers[LAYER_IDX_CHARACTERS][i]
+	AabbBatch characterBoxes;
+	vector<NarrowphaseScratch> narrowphaseScratch;
+	NarrowphaseScratch sweepScratch;
+	vector<PairContact> pairContacts;
+	//contacts found this frame waiting for their gameplay side effects to be applied
+	vector<ContactEvent> contactEvents;
+	//character and level contacts remembered between frames
+	ContactCache contactCache;
+	PhysicsStats physicsStats;
+	CollisionHeatmap heatmap;
+	vector<HitscanShot> hitscanShots;
+	vector<Tracer> tracers;
 	int playerIndex;
 	SDL_FRect mapViewport;
-	float bg2Scroll, bg3Scroll, bg4Scroll;
+	//the tiles and sprites get queued here and drawn a page at a time
+	SpriteBatch sprites;
+	//everything drawn in a frame gets recorded here first then sorted and sent to the batch in one go
+	RenderQueue renderQueue;
+	//debug shapes collected over the frame and drawn a colour at a time
+	DebugDraw debugDraw;
+	//the sky and the three scrolling backdrop layers drawn into one texture
+	ParallaxCompositor backdrop;
+	//drops the resolution the scene is drawn at when frames run over budget
+	DynamicResolution resolution;
 	bool debugMode;
+	bool hitscanMode;
+	bool heatmapMode;
+	bool editMode;
 
 	GameState(const SDLState &state) {
 		//represent none
@@ -49,11 +169,69 @@ struct GameState {
 			.w = static_cast<float>(state.logW),
 			.h = static_cast<float>(state.logH)
 		};
-		bg2Scroll = bg3Scroll = bg4Scroll = 0;
+		backdrop = ParallaxCompositor(state.logW, state.logH, SDL_Color{ 20, 10, 30, 255 });
+		resolution = DynamicResolution(state.logW, state.logH, FRAME_BUDGET, MIN_RESOLUTION_SCALE, RESOLUTION_STEP);
+		sprites = SpriteBatch(state.backend);
 		debugMode = false;
+		hitscanMode = false;
+		heatmapMode = false;
+		editMode = false;
+		//the map sits on the bottom of the screen same as createTiles places it
+		levelGrid = TileGrid(MAP_ROWS, MAP_COLS, 0, static_cast<float>(state.logH - MAP_ROWS * TILE_SIZE), TILE_SIZE);
+		levelTileGrid = backgroundTileGrid = foregroundTileGrid = tileHealth = levelGrid;
+		levelChunks = backgroundChunks = foregroundChunks = TileChunkCache(MAP_ROWS, MAP_COLS,
+			levelGrid.originX, levelGrid.originY, TILE_SIZE, TILE_CHUNK_COLS, TILE_CHUNK_BUDGET_BYTES);
+		decals = DecalLayer(MAP_ROWS, MAP_COLS, levelGrid.originX, levelGrid.originY, TILE_SIZE, TILE_CHUNK_COLS, DECAL_HISTORY_PER_CHUNK);
+		//the heatmap covers the sky above the map as well since characters and bullets go up there
+		heatmap = CollisionHeatmap(state.logH / TILE_SIZE, MAP_COLS, 0, 0, TILE_SIZE);
 	}
 
 	GameObject& player() { return layers[LAYER_IDX_CHARACTERS][playerIndex]; }
+
+	//everything baked into render targets, gets drawn again the next time its needed
+	void invalidateRenderTargets() {
+		levelChunks.invalidate();
+		backgroundChunks.invalidate();
+		foregroundChunks.invalidate();
+		decals.invalidate();
+		backdrop.invalidate();
+	}
+	void destroyRenderTargets(RenderBackend& backend) {
+		levelChunks.destroy(backend);
+		backgroundChunks.destroy(backend);
+		foregroundChunks.destroy(backend);
+		decals.destroy(backend);
+		backdrop.destroy(backend);
+		resolution.destroy(backend);
+	}
+
+	//works out which list an object lives in so it can be found again later even if that list grows
+	ObjectRef refOf(const GameObject& obj) {
+		const auto indexIn = [&obj](const vector<GameObject>& list) {
+			return &obj >= list.data() && &obj < list.data() + list.size() ? static_cast<int>(&obj - list.data()) : -1;
+		};
+		int index = indexIn(layers[LAYER_IDX_CHARACTERS]);
+		if (index != -1) {
+			return ObjectRef{ ObjectList::characters, static_cast<uint32_t>(index) };
+		}
+		index = indexIn(bullets);
+		if (index != -1) {
+			return ObjectRef{ ObjectList::bullets, static_cast<uint32_t>(index) };
+		}
+		index = indexIn(levelColliders);
+		assert(index != -1);
+		return ObjectRef{ ObjectList::level, static_cast<uint32_t>(index) };
+	}
+	GameObject& resolve(ObjectRef ref) {
+		switch (ref.list) {
+		case ObjectList::characters:
+			return layers[LAYER_IDX_CHARACTERS][ref.index];
+		case ObjectList::bullets:
+			return bullets[ref.index];
+		default:
+			return levelColliders[ref.index];
+		}
+	}
 };
 
 //this resources is helping both for setup as well as any other parts of the animation so the main can be neater
@@ -73,16 +251,33 @@ struct Resources {
 	vector<Animation> enemyAnims;
 
 	vector<SDL_Texture*> textures;
-	SDL_Texture* texIdle, *texRun, *texBrick, *texGrass, *texGround, *texPanel, *texSlide,
-		*texBg1, *texBg2, *texBg3, *texBg4, *texBullet, *texBulletHit,
-		*texShoot, *texRunShoot, *texSlideShoot, *texEnemy, *texEnemyDie, *texEnemyHit;
+	//every sprite sheet and tile packed onto shared pages, the backgrounds stay on their own since they get tiled
+	TextureAtlas atlas;
+	//the backgrounds pixels, kept for the software renderer since they arent on the atlas pages
+	vector<pair<SDL_Texture*, SDL_Surface*>> unpackedSurfaces;
+	//null until load so a Resources that never gets loaded, ie in the benchmarks, doesnt hand out garbage pointers
+	SDL_Texture* texIdle = nullptr, *texRun = nullptr, *texBrick = nullptr, *texGrass = nullptr, *texGround = nullptr,
+		*texPanel = nullptr, *texSlide = nullptr, *texBg1 = nullptr, *texBg2 = nullptr, *texBg3 = nullptr, *texBg4 = nullptr,
+		*texBullet = nullptr, *texBulletHit = nullptr, *texShoot = nullptr, *texRunShoot = nullptr, *texSlideShoot = nullptr,
+		*texEnemy = nullptr, *texEnemyDie = nullptr, *texEnemyHit = nullptr;
 
-	SDL_Texture* loadTexture(SDL_Renderer *renderer,const string& filepath) {
+	SDL_Texture* loadTexture(SDL_Renderer *renderer,const string& filepath, bool packed = true) {
 		//"data/AnimationSheet_Character.png"
 		//needs to use this c.string
-		SDL_Texture *tex = IMG_LoadTexture(renderer, filepath.c_str());
+		//load the pixels first so they can go into the atlas as well as their own texture
+		SDL_Surface* surface = IMG_Load(filepath.c_str());
+		SDL_Texture *tex = surface ? SDL_CreateTextureFromSurface(renderer, surface) : nullptr;
 		SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
 		textures.push_back(tex);
+		if (packed) {
+			atlas.add(tex, surface);
+		}
+		else if (tex) {
+			unpackedSurfaces.push_back({ tex, surface });
+		}
+		else {
+			SDL_DestroySurface(surface);
+		}
 		return tex;
 	}
 
@@ -109,10 +304,10 @@ struct Resources {
 		texGrass = loadTexture(state.renderer, "data/tiles/grass.png");
 		texGround = loadTexture(state.renderer, "data/tiles/ground.png");
 		texPanel = loadTexture(state.renderer, "data/tiles/panel.png");
-		texBg1 = loadTexture(state.renderer, "data/background/bg_layer1.png");
-		texBg2 = loadTexture(state.renderer, "data/background/bg_layer2.png");
-		texBg3 = loadTexture(state.renderer, "data/background/bg_layer3.png");
-		texBg4 = loadTexture(state.renderer, "data/background/bg_layer4.png");
+		texBg1 = loadTexture(state.renderer, "data/background/bg_layer1.png", false);
+		texBg2 = loadTexture(state.renderer, "data/background/bg_layer2.png", false);
+		texBg3 = loadTexture(state.renderer, "data/background/bg_layer3.png", false);
+		texBg4 = loadTexture(state.renderer, "data/background/bg_layer4.png", false);
 		texBullet = loadTexture(state.renderer, "data/bullet.png");
 		texBulletHit = loadTexture(state.renderer, "data/bullet_hit.png");
 		texShoot = loadTexture(state.renderer, "data/shoot.png");
@@ -121,27 +316,88 @@ struct Resources {
 		texEnemy = loadTexture(state.renderer, "data/enemy.png");
 		texEnemyDie = loadTexture(state.renderer, "data/enemy_die.png");
 		texEnemyHit = loadTexture(state.renderer, "data/enemy_hit.png");
+		atlas.build(state.renderer);
+		//the packed images draw off the pages now so their own textures would only double the memory
+		//the pointers stay on as atlas keys and their sizes come from the regions from here on
+		erase_if(textures, [this](SDL_Texture* tex) {
+			if (!atlas.find(tex)) {
+				return false;
+			}
+			SDL_DestroyTexture(tex);
+			return true;
+		});
+	}
+	//height of an image whether it got packed or kept its own texture, a packed one has no texture left to ask
+	float textureHeight(const SDL_Texture* tex) const {
+		const AtlasRegion* region = atlas.find(tex);
+		return region ? region->rect.h : static_cast<float>(tex->h);
+	}
+	//hands the software renderer the pixels of everything the game draws from
+	void addSources(SoftwareRenderBackend& backend) {
+		for (size_t i = 0; i < atlas.pages.size(); i++) {
+			backend.addSource(atlas.pages[i], atlas.pageSurfaces[i]);
+		}
+		for (auto& [tex, surface] : unpackedSurfaces) {
+			backend.addSource(tex, surface);
+		}
 	}
 	void unload() {
+		atlas.destroy();
+		for (auto& [tex, surface] : unpackedSurfaces) {
+			SDL_DestroySurface(surface);
+		}
+		unpackedSurfaces.clear();
 		for (SDL_Texture* tex : textures) {
 			SDL_DestroyTexture(tex);
 		}
+		textures.clear();
 	}
 };
 
 //function decleration area
 void cleanup(SDLState& state);
 bool initialize(SDLState& state);
-void drawObject(const SDLState& state, GameState& gs, GameObject& obj,float width, float height, float deltaTime);
+void drawObject(const SDLState& state, GameState& gs, const Resources& res, GameObject& obj,float width, float height, float deltaTime);
 void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime);
 void createTiles(const SDLState& state, GameState& gs, const Resources& res);
-void checkCollision(const SDLState& state, GameState& gs, const Resources& res, GameObject& a, GameObject& b, float deltaTime);
+bool checkCollision(const SDLState& state, GameState& gs, const Resources& res, GameObject& a, GameObject& b, float deltaTime);
+void collisionResponse(const SDLState& state, GameState& gs, const Resources& res,
+	const SDL_FRect& rectA, const SDL_FRect& rectB, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime);
 void handleKeyInput(const SDLState& state, GameState& gs, GameObject& obj, SDL_Scancode key, bool keyDown);
-void drawParralaxBackground(SDL_Renderer* renderer, SDL_Texture* texture, float xVelocity, float& scrollPos, float scrollFactor, float deltaTime);
+void wake(GameObject& obj);
+void applyContactEvents(const SDLState& state, GameState& gs, const Resources& res);
+void narrowphase(const SDLState& state, GameState& gs, const Resources& res, WorkerPool& workers, float deltaTime);
+void packCharacterBoxes(GameState& gs);
+float sweepMove(GameState& gs, const GameObject& obj, vec2 step);
+void fireHitscanShots(GameState& gs);
+void rebuildLevelColliders(GameState& gs, int chunk);
+void setLevelTile(GameState& gs, const Resources& res, int r, int c, int type);
+int runNarrowphaseBenchmark(int enemyCount, int bulletCount, int iterations);
+void drawTileChunks(const SDLState& state, GameState& gs, const Resources& res, TileChunkCache& chunks, const TileGrid& grid, const vector<GameObject>& tiles, RenderLayer layer);
+void initBackdrop(GameState& gs, const Resources& res);
+void stepFrame(const SDLState& state, GameState& gs, Resources& res, WorkerPool& workers, float deltaTime);
+void drawFrame(const SDLState& state, GameState& gs, const Resources& res, float deltaTime);
+int runRenderBenchmark(int frames);
+int runGoldenFrames(bool record);
 
 int main(int argc, char* argv[]) {
 //it needs this argc and argv as well as its pulling it from the command line
 //NB You can only have one main file in your project like this otherwise it gets a little confused :)
+	//run a benchmark instead of the game ie SDL3Practice --bench-aabb
+	if (argc > 1 && string(argv[1]) == "--bench-aabb") {
+		return runAabbBenchmark(256, 20000) ? 0 : 1;
+	}
+	if (argc > 1 && string(argv[1]) == "--bench-narrowphase") {
+		return runNarrowphaseBenchmark(400, 2000, 50);
+	}
+	if (argc > 1 && string(argv[1]) == "--bench-render") {
+		return runRenderBenchmark(600);
+	}
+	//SDL3Practice --golden checks the scripted frames against the set in data/golden, --golden record writes it
+	if (argc > 1 && string(argv[1]) == "--golden") {
+		return runGoldenFrames(argc > 2 && string(argv[2]) == "record");
+	}
 	SDLState state;
 	state.width = 1600;
 	state.height = 900;
@@ -150,12 +406,31 @@ int main(int argc, char* argv[]) {
 	if (!initialize(state)) {
 		return 1;
 	}
+	//the main thread counts as a worker so only start threads for the other cores
+	WorkerPool workers(max(1, SDL_GetNumLogicalCPUCores()) - 1);
+	//SDL3Practice --null-renderer runs the game without drawing anything, the debug text wont show either
+	//SDL3Practice --software-renderer draws everything on the cpu and only hands sdl the finished frame
+	SdlRenderBackend sdlBackend(state.renderer);
+	NullRenderBackend nullBackend(state.renderer);
+	const bool nullRenderer = argc > 1 && string(argv[1]) == "--null-renderer";
+	const bool softwareRenderer = argc > 1 && string(argv[1]) == "--software-renderer";
+	//the software renderer holds a whole frame and its own copy of every texture so its only made when asked for
+	unique_ptr<SoftwareRenderBackend> softwareBackend;
+	if (softwareRenderer) {
+		softwareBackend = make_unique<SoftwareRenderBackend>(state.renderer, state.logW, state.logH, workers);
+	}
+	state.backend = nullRenderer ? static_cast<RenderBackend*>(&nullBackend)
+		: softwareRenderer ? static_cast<RenderBackend*>(softwareBackend.get()) : &sdlBackend;
 	//load game assets
 	Resources res;
 	res.load(state);
+	if (softwareBackend) {
+		res.addSources(*softwareBackend);
+	}
 	//setup game data
 	GameState gs(state);
 	createTiles(state, gs, res);
+	initBackdrop(gs, res);
 
 	
 	uint64_t prevTime = SDL_GetTicks();
@@ -179,6 +454,10 @@ int main(int argc, char* argv[]) {
 				state.width = event.window.data1;
 				state.height = event.window.data2;
 				break;
+			case SDL_EVENT_RENDER_TARGETS_RESET:
+				//whatever was baked into the tile chunks and backdrop is gone
+				gs.invalidateRenderTargets();
+				break;
 			case SDL_EVENT_KEY_DOWN:
 				handleKeyInput(state, gs, gs.player(), event.key.scancode, true);
 				break;
@@ -187,99 +466,62 @@ int main(int argc, char* argv[]) {
 				if (event.key.scancode == SDL_SCANCODE_F12) {
 					gs.debugMode = !gs.debugMode;
 				}
+				if (event.key.scancode == SDL_SCANCODE_F11) {
+					gs.heatmapMode = !gs.heatmapMode;
+				}
+				//swap between firing bullets and instant hitscan shots
+				if (event.key.scancode == SDL_SCANCODE_H) {
+					gs.hitscanMode = !gs.hitscanMode;
+				}
+				//edit mode lets the mouse place and remove panels
+				if (event.key.scancode == SDL_SCANCODE_E) {
+					gs.editMode = !gs.editMode;
+				}
+				//dynamic resolution on and off
+				if (event.key.scancode == SDL_SCANCODE_F10) {
+					gs.resolution.enabled = !gs.resolution.enabled;
+				}
+				break;
+			case SDL_EVENT_MOUSE_BUTTON_DOWN:
+				if (gs.editMode) {
+					//window pixels to logical pixels then shift by the camera to get to the world
+					SDL_ConvertEventToRenderCoordinates(state.renderer, &event);
+					int r, c;
+					if (gs.levelTileGrid.cellAt(event.button.x + gs.mapViewport.x, event.button.y + gs.mapViewport.y, r, c)) {
+						if (event.button.button == SDL_BUTTON_LEFT && gs.levelTileGrid.get(r, c) == -1) {
+							setLevelTile(gs, res, r, c, 2);
+						}
+						else if (event.button.button == SDL_BUTTON_RIGHT) {
+							setLevelTile(gs, res, r, c, 0);
+						}
+					}
+				}
 				break;
 				
 		}
 			
 		}
-		//update all objects
-		for (auto& layer : gs.layers) {
-			for (GameObject& obj : layer) {
-				update(state, gs, res, obj, deltaTime);
-				//update the animation
-				
-			}
-		}
-
-		//update bullets
-		for (GameObject& bullet : gs.bullets) {
-			update(state, gs, res, bullet, deltaTime);
-			//update the animation
-			
-		}
-		
-		//calculate viewport position
-		//generating an x cooredinmate based off the player so that we can center it on the player
-		gs.mapViewport.x = (gs.player().position.x + TILE_SIZE / 2) - gs.mapViewport.w / 2;
+		//move everything and sort out the collisions
+		stepFrame(state, gs, res, workers, deltaTime);
 		
 		//perform drawing
-		SDL_SetRenderDrawColor(state.renderer, 20, 10, 30, 255);
-		SDL_RenderClear(state.renderer);
-
-		//draw Background images
-		float scrollFactor = 0.3f;
-		SDL_RenderTexture(state.renderer, res.texBg1, nullptr, nullptr);
-		drawParralaxBackground(state.renderer, res.texBg4, gs.player().velocity.x, gs.bg4Scroll, scrollFactor / 4, deltaTime);
-		drawParralaxBackground(state.renderer, res.texBg3, gs.player().velocity.x, gs.bg3Scroll, scrollFactor / 2, deltaTime);
-		drawParralaxBackground(state.renderer, res.texBg2, gs.player().velocity.x, gs.bg2Scroll, scrollFactor, deltaTime);
-
-		//draw background tiles
-		for (GameObject& obj : gs.backgroundTiles) {
-			SDL_FRect dst{
-				.x = obj.position.x - gs.mapViewport.x,
-				.y = obj.position.y,
-				.w = static_cast<float>(obj.texture->w),
-				.h = static_cast<float>(obj.texture->h)
-			};
-			SDL_RenderTexture(state.renderer, obj.texture, nullptr, &dst);
-		 }
-
-		
-		
-		//so they were using intialiazers which i dont have not sure how to update to latest version of C++
-		//but x,y,width height are whats being used here
-		//draw all objects
-		for (auto& layer : gs.layers) {
-			for (GameObject& obj : layer) {
-				drawObject(state, gs, obj,TILE_SIZE,TILE_SIZE, deltaTime);
-			}
-		}
-
-		//draw bullets
-		for (GameObject& bullet : gs.bullets) {
-			if (bullet.data.bullet.state != BulletState::inactive) {
-				drawObject(state, gs, bullet, bullet.collider.w, bullet.collider.h, deltaTime);
-			}
-			
-		}
-		
-		//draw foreground tiles
-		for (GameObject& obj : gs.foregroundTiles) {
-			SDL_FRect dst{
-				.x = obj.position.x - gs.mapViewport.x,
-				.y = obj.position.y,
-				.w = static_cast<float>(obj.texture->w),
-				.h = static_cast<float>(obj.texture->h)
-			};
-			SDL_RenderTexture(state.renderer, obj.texture, nullptr, &dst);
-		}
-
-		if (gs.debugMode) {
-			//display some debug info
-			SDL_SetRenderDrawColor(state.renderer, 255, 255, 255, 255);
-			//need to cast to int then to string so 0,1,2 which will correspond to idle running jumping respectively
-			SDL_RenderDebugText(state.renderer, 5, 5,
-				format("State: {}, B: {}, G: {}"
-					, static_cast<int>(gs.player().data.player.state), gs.bullets.size(), gs.player().grounded).c_str());
-		}
-		
+		//at a reduced scale the scene goes into a smaller target first and gets stretched over the screen after
+		//only drawing is timed since events and physics cost the same at any resolution
+		//flush only hands the commands over, so with a gpu renderer this is our side of drawing and not the gpus
+		const Uint64 drawStart = SDL_GetPerformanceCounter();
+		gs.resolution.begin(*state.backend);
+		drawFrame(state, gs, res, deltaTime);
+		gs.resolution.end(*state.backend, gs.sprites);
+		state.backend->flush();
+		gs.resolution.frameTime(static_cast<float>(secondsSince(drawStart)));
 
 		//swap buffer
-		SDL_RenderPresent(state.renderer);
+		state.backend->present();
 		//dont necessarily need it here but makes it readable
 		prevTime = nowTime;
 	}
 
+	gs.destroyRenderTargets(*state.backend);
 	res.unload();
 	cleanup(state);
 	return 0;
@@ -327,14 +569,17 @@ bool initialize(SDLState& state) {
 }
 
 //taking these by reference
-void drawObject(const SDLState& state, GameState& gs, GameObject& obj, float width,float height, float deltaTime) {
+void drawObject(const SDLState& state, GameState& gs, const Resources& res, GameObject& obj, float width,float height, float deltaTime) {
 	
 	//sees if its animated if it does its going to try to grab the current frame
-	float srcX = obj.currentAnimation != -1 ? obj.animations[obj.currentAnimation].currentFrame() * width 
-		: (obj.spriteFrame - 1) * width;
+	const int frame = obj.currentAnimation != -1 ? obj.animations[obj.currentAnimation].currentFrame()
+		: obj.spriteFrame - 1;
+	//draw off the atlas page when the sheet got packed so everything on that page shares one texture
+	const AtlasRegion* region = res.atlas.find(obj.texture);
+	SDL_Texture* tex = region ? res.atlas.pages[region->page] : obj.texture;
 	//you can directly instantiate ie srcx,0,sprite size within rect but this looks cleaner
-	SDL_FRect src{ 
-		.x = srcX,
+	SDL_FRect src = region ? res.atlas.frameRect(*region, frame, width, height) : SDL_FRect{
+		.x = frame * width,
 		.y = 0,
 		.w = width,
 		.h = height 
@@ -350,40 +595,259 @@ void drawObject(const SDLState& state, GameState& gs, GameObject& obj, float wid
 	//be able to flip the sprite
 	//takes an angle of rotation, centerpoint as well as direction you want to flip it
 	//using a ternary to determine when it should be flipped
-	SDL_FlipMode flipMode = obj.direction == -1 ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
-	if (!obj.shouldFlash) {
-		SDL_RenderTextureRotated(state.renderer, obj.texture, &src, &dst, 0, nullptr, flipMode);
-	}
-	else {
+	//the batch flips by swapping the u coordinates so facing left doesnt need its own call
+	const bool flip = obj.direction == -1;
+	const RenderLayer layer = obj.type == ObjectType::bullet ? RenderLayer::bullets : RenderLayer::characters;
+	//anything off screen doesnt get sent to the renderer at all
+	const SDL_FRect screen{ 0, 0, gs.mapViewport.w, gs.mapViewport.h };
+	const bool onScreen = SDL_HasRectIntersectionFloat(&dst, &screen);
+	if (onScreen) {
 		//red flash
-		SDL_SetTextureColorModFloat(obj.texture, 2.5f, 1.0f, 1.0f);
-		SDL_RenderTextureRotated(state.renderer, obj.texture, &src, &dst, 0, nullptr, flipMode);
-		SDL_SetTextureColorModFloat(obj.texture, 1.0f, 1.0f, 1.0f);
-		if (obj.flashTimer.step(deltaTime)) {
-			obj.shouldFlash = false;
+		//the tint goes on this sprites vertices so it batches with everything else on the page
+		gs.renderQueue.sprite(layer, tex, src, dst, flip, obj.shouldFlash ? HIT_FLASH_TINT : SDL_FColor{ 1, 1, 1, 1 });
+	}
+	//the flash runs out even while off screen
+	if (obj.shouldFlash && obj.flashTimer.step(deltaTime)) {
+		obj.shouldFlash = false;
+	}
+}
+
+//one frame of the game without input or drawing, ends with the camera following the player
+void stepFrame(const SDLState& state, GameState& gs, Resources& res, WorkerPool& workers, float deltaTime) {
+	//start counting this frames collision work
+	gs.physicsStats.reset();
+	gs.heatmap.decay(HEATMAP_DECAY);
+
+	//update all objects
+	for (auto& layer : gs.layers) {
+		for (GameObject& obj : layer) {
+			update(state, gs, res, obj, deltaTime);
+			//update the animation
+			
+		}
+	}
+
+	//characters are done moving so pack them for the bullet sweeps and narrowphase
+	packCharacterBoxes(gs);
+	fireHitscanShots(gs);
+
+	//update bullets
+	for (GameObject& bullet : gs.bullets) {
+		update(state, gs, res, bullet, deltaTime);
+		//update the animation
+		
+	}
+
+	//everything has moved so now find out who ran into who
+	narrowphase(state, gs, res, workers, deltaTime);
+	//physics is done so now apply what all the contacts mean for the game
+	applyContactEvents(state, gs, res);
+	//fade out the tracers and drop the ones that are done
+	for (Tracer& tracer : gs.tracers) {
+		tracer.life.step(deltaTime);
+	}
+	erase_if(gs.tracers, [](const Tracer& tracer) { return tracer.life.isTimeout(); });
+	//forget level contacts nobody has touched in a while
+	gs.contactCache.endFrame(GROUND_GRACE_FRAMES);
+	for (const GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS]) {
+		gs.physicsStats.sleepingBodies += obj.sleeping;
+	}
+	
+	//calculate viewport position
+	//generating an x cooredinmate based off the player so that we can center it on the player
+	gs.mapViewport.x = (gs.player().position.x + TILE_SIZE / 2) - gs.mapViewport.w / 2;
+}
+
+//the sky is stretched over the whole screen and never moves, the rest are drawn at their own size
+void initBackdrop(GameState& gs, const Resources& res) {
+	gs.backdrop.addLayer(res.texBg1, 0, gs.mapViewport.w, gs.mapViewport.h, 0);
+	gs.backdrop.addLayer(res.texBg4, 30, static_cast<float>(res.texBg4->w), static_cast<float>(res.texBg4->h), PARALLAX_SCROLL_FACTOR / 4);
+	gs.backdrop.addLayer(res.texBg3, 30, static_cast<float>(res.texBg3->w), static_cast<float>(res.texBg3->h), PARALLAX_SCROLL_FACTOR / 2);
+	gs.backdrop.addLayer(res.texBg2, 30, static_cast<float>(res.texBg2->w), static_cast<float>(res.texBg2->h), PARALLAX_SCROLL_FACTOR);
+}
+
+//draws one frame through the backend from wherever the viewport is, everything but presenting it
+void drawFrame(const SDLState& state, GameState& gs, const Resources& res, float deltaTime) {
+	RenderBackend& backend = *state.backend;
+	backend.beginFrame();
+	gs.sprites.beginFrame();
+	backend.setDrawColor(20, 10, 30, 255);
+	backend.clear();
+
+	//draw Background images
+	//nothing below goes to the renderer until the queue is submitted, the layer decides what ends up in front
+	RenderQueue& queue = gs.renderQueue;
+	gs.backdrop.scroll(gs.player().velocity.x, deltaTime);
+	gs.backdrop.draw(backend, gs.sprites, queue, RenderLayer::sky);
+
+	//draw background tiles
+	drawTileChunks(state, gs, res, gs.backgroundChunks, gs.backgroundTileGrid, gs.backgroundTiles, RenderLayer::backgroundTiles);
+
+	
+	
+	//so they were using intialiazers which i dont have not sure how to update to latest version of C++
+	//but x,y,width height are whats being used here
+	//draw all objects
+	drawTileChunks(state, gs, res, gs.levelChunks, gs.levelTileGrid, gs.layers[LAYER_IDX_LEVEL], RenderLayer::levelTiles);
+	gs.decals.draw(backend, gs.sprites, queue, RenderLayer::decals, gs.mapViewport);
+	for (GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS]) {
+		drawObject(state, gs, res, obj,TILE_SIZE,TILE_SIZE, deltaTime);
+	}
+
+	//draw bullets
+	for (GameObject& bullet : gs.bullets) {
+		if (bullet.data.bullet.state != BulletState::inactive) {
+			drawObject(state, gs, res, bullet, bullet.collider.w, bullet.collider.h, deltaTime);
 		}
+		
+	}
+
+	//draw the hitscan tracers fading out over their life
+	for (const Tracer& tracer : gs.tracers) {
+		const float alpha = 1 - tracer.life.getTime() / tracer.life.getLength();
+		queue.line(RenderLayer::tracers, tracer.start.x - gs.mapViewport.x, tracer.start.y,
+			tracer.end.x - gs.mapViewport.x, tracer.end.y, SDL_FColor{ 1, 230 / 255.0f, 120 / 255.0f, alpha });
 	}
+	
+	//draw foreground tiles
+	drawTileChunks(state, gs, res, gs.foregroundChunks, gs.foregroundTileGrid, gs.foregroundTiles, RenderLayer::foregroundTiles);
+
+	//colour each cell by how many pair tests happened around it lately compared to the busiest cell
+	if (gs.heatmapMode) {
+		const float peak = max(gs.heatmap.peak(), 1.0f);
+		for (int r = 0; r < gs.heatmap.rows; r++) {
+			for (int c = 0; c < gs.heatmap.cols; c++) {
+				const float heat = gs.heatmap.heat[r * gs.heatmap.cols + c] / peak;
+				if (heat < 0.01f) {
+					continue;
+				}
+				SDL_FRect rect{
+					.x = gs.heatmap.originX + c * gs.heatmap.cellSize - gs.mapViewport.x,
+					.y = gs.heatmap.originY + r * gs.heatmap.cellSize,
+					.w = gs.heatmap.cellSize,
+					.h = gs.heatmap.cellSize
+				};
+				queue.fillRect(RenderLayer::overlay, rect, SDL_FColor{ 1, 1 - heat, 0, (40 + 160 * heat) / 255 });
+			}
+		}
+	}
+
+	//sort and draw everything recorded this frame
+	queue.submit(backend, gs.sprites);
 
 	if (gs.debugMode) {
-		SDL_FRect rectA{
-		.x = obj.position.x + obj.collider.x - gs.mapViewport.x,
-		.y = obj.position.y + obj.collider.y,
-		.w = obj.collider.w,
-		.h = obj.collider.h
+		//characters and bullets colliders, level tiles dont collide themselves
+		DebugDraw& debug = gs.debugDraw;
+		const auto colliderRect = [&gs](const GameObject& obj) {
+			return SDL_FRect{
+				.x = obj.position.x + obj.collider.x - gs.mapViewport.x,
+				.y = obj.position.y + obj.collider.y,
+				.w = obj.collider.w,
+				.h = obj.collider.h
+			};
 		};
-		SDL_SetRenderDrawBlendMode(state.renderer, SDL_BLENDMODE_BLEND);
-		SDL_SetRenderDrawColor(state.renderer, 255, 0, 0, 150);
-		SDL_RenderFillRect(state.renderer, &rectA);
-		SDL_SetRenderDrawBlendMode(state.renderer, SDL_BLENDMODE_NONE);
+		for (const GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS]) {
+			const SDL_FRect rect = colliderRect(obj);
+			debug.fillRect(rect, SDL_Color{ 255, 0, 0, 150 });
+			//the ground sensor just under the feet
+			debug.rect(SDL_FRect{ rect.x, rect.y + rect.h, rect.w, 1 }, SDL_Color{ 255, 255, 0, 255 });
+			//the level cells update looks at for this body
+			int r0, c0, r1, c1;
+			const SDL_FRect world{ rect.x + gs.mapViewport.x, rect.y, rect.w, rect.h };
+			if (gs.levelGrid.cellRange(world, r0, c0, r1, c1, 1)) {
+				debug.rect(SDL_FRect{
+					.x = gs.levelGrid.originX + c0 * TILE_SIZE - gs.mapViewport.x,
+					.y = gs.levelGrid.originY + r0 * TILE_SIZE,
+					.w = static_cast<float>((c1 - c0 + 1) * TILE_SIZE),
+					.h = static_cast<float>((r1 - r0 + 1) * TILE_SIZE)
+				}, SDL_Color{ 0, 200, 255, 120 });
+			}
+			const float cx = rect.x + rect.w / 2, cy = rect.y + rect.h / 2;
+			debug.line(cx, cy, cx + obj.velocity.x * DEBUG_VELOCITY_SCALE, cy + obj.velocity.y * DEBUG_VELOCITY_SCALE,
+				SDL_Color{ 255, 255, 255, 255 });
+		}
+		for (const GameObject& bullet : gs.bullets) {
+			if (bullet.data.bullet.state != BulletState::inactive) {
+				debug.fillRect(colliderRect(bullet), SDL_Color{ 255, 0, 0, 150 });
+			}
+		}
+		//show the merged level colliders since thats what actually gets collided with
+		for (const GameObject& obj : gs.levelColliders) {
+			//free slots are left with an empty collider
+			if (obj.collider.w != 0) {
+				debug.rect(colliderRect(obj), SDL_Color{ 0, 255, 0, 255 });
+			}
+		}
+		debug.flush(backend);
+		//display some debug info
+		backend.setDrawColor(255, 255, 255, 255);
+		//need to cast to int then to string so 0,1,2 which will correspond to idle running jumping respectively
+		backend.debugText(5, 5,
+			format("State: {}, B: {}, G: {}, H: {}, E: {}"
+				, static_cast<int>(gs.player().data.player.state), gs.bullets.size(), gs.player().grounded, gs.hitscanMode
+				, gs.editMode).c_str());
+		const PhysicsStats& stats = gs.physicsStats;
+		backend.debugText(5, 15,
+			format("Cand: {}, Tests: {}, Hits: {}, Resolved: {}, Cached: {}, Asleep: {}"
+				, stats.broadphaseCandidates, stats.narrowphaseTests, stats.hits, stats.resolvedContacts
+				, stats.cacheHits, stats.sleepingBodies).c_str());
+		backend.debugText(5, 25,
+			format("Sprites: {}, Batches: {}, Chunks: {}, Cmds: {}, Changes: {}", gs.sprites.spriteCount, gs.sprites.flushCount,
+				gs.levelChunks.bakedCount() + gs.backgroundChunks.bakedCount() + gs.foregroundChunks.bakedCount(),
+				gs.renderQueue.submittedCount, gs.renderQueue.stateChanges).c_str());
+		backend.debugText(5, 35, format("Debug calls: {}, Backdrop redraws: {}, Direct: {}",
+			gs.debugDraw.callCount, gs.backdrop.recomposeCount, gs.backdrop.directCount).c_str());
+		backend.debugText(5, 45, format("Backend: {}, Calls: {}, Verts: {}, State: {}, Res: {}x{}", backend.name(),
+			backend.counters.drawCalls, backend.counters.vertices, backend.counters.stateChanges,
+			gs.resolution.scaledWidth(), gs.resolution.scaledHeight()).c_str());
 	}
 }
 
+//draws a static tile layer from its baked chunks, baking the ones coming on screen for the first time
+//the tiles get copied into the chunk as is rather than blended since nothing in one layer overlaps
+void drawTileChunks(const SDLState& state, GameState& gs, const Resources& res, TileChunkCache& chunks, const TileGrid& grid, const vector<GameObject>& tiles, RenderLayer layer) {
+	chunks.draw(*state.backend, gs.sprites, gs.renderQueue, layer, gs.mapViewport, [&](int c0, int c1, float chunkX, float chunkY) {
+		for (SDL_Texture* page : res.atlas.pages) {
+			SDL_SetTextureBlendMode(page, SDL_BLENDMODE_NONE);
+		}
+		for (int r = 0; r < grid.rows; r++) {
+			for (int c = c0; c <= c1; c++) {
+				const int index = grid.get(r, c);
+				if (index == -1) {
+					continue;
+				}
+				const GameObject& tile = tiles[index];
+				const AtlasRegion* region = res.atlas.find(tile.texture);
+				SDL_Texture* tex = region ? res.atlas.pages[region->page] : tile.texture;
+				const SDL_FRect src = region ? res.atlas.frameRect(*region, tile.spriteFrame - 1, TILE_SIZE, TILE_SIZE)
+					: SDL_FRect{ (tile.spriteFrame - 1.0f) * TILE_SIZE, 0, TILE_SIZE, TILE_SIZE };
+				gs.sprites.draw(tex, src, SDL_FRect{ tile.position.x - chunkX, tile.position.y - chunkY, TILE_SIZE, TILE_SIZE }, false);
+			}
+		}
+		gs.sprites.flush();
+		for (SDL_Texture* page : res.atlas.pages) {
+			SDL_SetTextureBlendMode(page, SDL_BLENDMODE_BLEND);
+		}
+	});
+}
+
 void update(const SDLState& state, GameState& gs, Resources& res, GameObject& obj, float deltaTime) {
 	//update the animation
 	if (obj.currentAnimation != -1) {
 		//this ties the core game loop to animations
 		obj.animations[obj.currentAnimation].step(deltaTime);
 	}
+	//sleeping bodies skip gravity, movement and collisions until something wakes them
+	if (obj.sleeping) {
+		//a shambling enemy wakes back up once the player is close enough to chase
+		if (obj.type == ObjectType::enemy && obj.data.enemy.state == EnemyState::shambling &&
+			length(gs.player().position - obj.position) < ENEMY_SIGHT_RANGE) {
+			wake(obj);
+		}
+		else {
+			return;
+		}
+	}
 	if (obj.dynamic && !obj.grounded) {
 		//apply some gravity
 		obj.velocity += vec2(0, 500) * deltaTime;
@@ -413,36 +877,49 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 				if (weaponTimer.isTimeout()) {
 					weaponTimer.reset();
 				}
+				const int yVariation = 20;
+				const float yVelocity = SDL_rand(yVariation) - yVariation / 2.0f;//returns a value from -30 to 30
+				//adjust bullet start position
+				const float left = 4;
+				const float right = 24;
+				const float t = (obj.direction + 1) / 2.0f; //results in a value of 0 or 1
+				const float xOffset = left + right * t; //LERP equation
+				const vec2 start(
+					obj.position.x + xOffset,
+					obj.position.y + TILE_SIZE / 2 + 1
+				);
+				//hitscan mode skips the bullet and fires a ray from the middle of where it would have been
+				if (gs.hitscanMode) {
+					const float bulletSize = res.textureHeight(res.texBullet);
+					gs.hitscanShots.push_back(HitscanShot{
+						gs.refOf(obj),
+						start + vec2(bulletSize / 2),
+						normalize(vec2(600.0f * obj.direction, yVelocity))
+					});
+					return;
+				}
 				//spawn some bullets
 				GameObject bullet;
 				bullet.data.bullet = BulletData();
 				bullet.type = ObjectType::bullet;
+				bullet.collisionCategory = categoryOf(ObjectType::bullet);
+				bullet.collisionMask = defaultMaskOf(ObjectType::bullet);
 				bullet.direction = gs.player().direction;
 				bullet.texture = res.texBullet;
 				bullet.currentAnimation = res.ANIM_BULLET_MOVING;
 				bullet.collider = SDL_FRect{
 					.x = 0,
 					.y = 0,
-					.w = static_cast<float>(res.texBullet->h),
-					.h = static_cast<float>(res.texBullet->h)
+					.w = res.textureHeight(res.texBullet),
+					.h = res.textureHeight(res.texBullet)
 				};
-				const int yVariation = 20;
-				const float yVelocity = SDL_rand(yVariation) - yVariation / 2.0f;//returns a value from -30 to 30
 				bullet.velocity = vec2(
 					obj.velocity.x + 600.0f * obj.direction, 
 					yVelocity
 				);
 				bullet.maxSpeedX = 1000.0f;
 				bullet.animations = res.bulletAnims;
-				//adjust bullet start position
-				const float left = 4;
-				const float right = 24;
-				const float t = (obj.direction + 1) / 2.0f; //results in a value of 0 or 1
-				const float xOffset = left + right * t; //LERP equation
-				bullet.position = vec2(
-					obj.position.x + xOffset,
-					obj.position.y + TILE_SIZE / 2 + 1
-				);
+				bullet.position = start;
 				//look for an inactive slot and overwrite with a new bullet
 				bool foundInactive = false;
 				for (int i = 0; i < gs.bullets.size() && !foundInactive; i++) {
@@ -546,10 +1023,10 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 	else if (obj.type == ObjectType::enemy) { //handling the enemy object updates
 	EnemyData &d = obj.data.enemy;
 	switch (d.state) {
-		case EnemyState::shambling:
+		case EnemyState::shambling: {
 			//basic enemy movement
 			vec2 playerDir = gs.player().position - obj.position;
-			if (length(playerDir) < 100) {
+			if (length(playerDir) < ENEMY_SIGHT_RANGE) {
 				currentDirection = playerDir.x < 0 ? -1 : 1;
 				obj.acceleration = vec2(30, 0);
 			}
@@ -558,6 +1035,7 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 				obj.velocity.x = 0;
 			}
 			break;
+		}
 		case EnemyState::damaged :
 			if (d.damageTimer.step(deltaTime)) {
 				d.state = EnemyState::shambling;
@@ -586,41 +1064,127 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 		obj.velocity.x = currentDirection * obj.maxSpeedX;
 	}
 	//add velocity to positionm
-	obj.position += obj.velocity * deltaTime;
+	//anything moving more than half its own size in one frame could skip straight over a wall or an enemy
+	//so sweep it first and cut the move short where it would first touch something
+	vec2 step = obj.velocity * deltaTime;
+	if (abs(step.x) > obj.collider.w / 2 || abs(step.y) > obj.collider.h / 2) {
+		const float t = sweepMove(gs, obj, step);
+		if (t <= 1) {
+			//go a hair past the point of contact so the normal collision checks see the hit
+			step *= min(1.0f, t + 0.01f / length(step));
+		}
+	}
+	obj.position += step;
 
 	//handle coillisions
-	//compare memory addresses then handle the collisions
-	//this approach isnt effecient at all but we will do it for now
-	//can optimize
+	//level colliders sit on the tile grid so only the cells around the collider need checking
+	//padded by a cell so a push out into a neighbouring cell still gets resolved like it used to
+	//a merged collider covers a block of cells so only test it at the first cell of the block we come across
+	SDL_FRect rectA{
+		.x = obj.position.x + obj.collider.x,
+		.y = obj.position.y + obj.collider.y,
+		.w = obj.collider.w,
+		.h = obj.collider.h
+	};
+	int r0, c0, r1, c1;
+	const bool hitsLevel = obj.collisionMask & categoryOf(ObjectType::level);
+	//characters remember their level contacts between frames, bullets never come to rest so they dont bother
+	const bool useCache = hitsLevel && obj.type != ObjectType::bullet;
+	const ObjectRef bodyRef = useCache ? gs.refOf(obj) : ObjectRef{};
+	//pushing out a body with no velocity never moves it, so a still body in the same spot as when a contact
+	//was last resolved would get the exact same answer and the check can be skipped
+	const bool resting = obj.velocity.x == 0 && obj.velocity.y == 0;
+	const auto bodyRect = [&obj]() {
+		return SDL_FRect{
+			.x = obj.position.x + obj.collider.x,
+			.y = obj.position.y + obj.collider.y,
+			.w = obj.collider.w,
+			.h = obj.collider.h
+		};
+	};
+	if (hitsLevel && gs.levelGrid.cellRange(rectA, r0, c0, r1, c1, 1)) {
+		for (int r = r0; r <= r1; r++) {
+			for (int c = c0; c <= c1; c++) {
+				int colliderIndex = gs.levelGrid.get(r, c);
+				if (colliderIndex != -1 && gs.levelGrid.firstInRange(r, c, r0, c0)) {
+					gs.physicsStats.broadphaseCandidates++;
+					const uint64_t key = ContactCache::key(bodyRef, colliderIndex);
+					CachedContact* contact = useCache ? gs.contactCache.find(key) : nullptr;
+					if (contact && resting && sameRect(contact->bodyRect, rectA)) {
+						gs.contactCache.keep(*contact);
+						gs.physicsStats.cacheHits++;
+					}
+					else if (checkCollision(state, gs, res, obj, gs.levelColliders[colliderIndex], deltaTime) && useCache) {
+						gs.contactCache.touch(key, bodyRect());
+					}
+				}
+			}
+		}
+	}
+	//grounded sensor
+	//when this hits any level collider we know the player has landed, nothing can stand on a level it passes through
 	bool foundGround = false;
-	for (auto& layer : gs.layers) {
-		for (GameObject& objB : layer) {
-			if (&obj != &objB) {
-				checkCollision(state, gs, res, obj, objB, deltaTime);
-				if (objB.type == ObjectType::level) {
-					//grounded sensor
-				//when this hits any object on the ground we know the player has landed
-					SDL_FRect sensor{
-						.x = obj.position.x + obj.collider.x,
-						.y = obj.position.y + obj.collider.y + obj.collider.h,
-						.w = obj.collider.w,
-						.h = 1
-					};
-					SDL_FRect rectB{
-						.x = objB.position.x + objB.collider.x,
-						.y = objB.position.y + objB.collider.y,
-						.w = objB.collider.w,
-						.h = objB.collider.h
-					};
-					SDL_FRect rectC{ 0 };
-					if (SDL_GetRectIntersectionFloat(&sensor, &rectB, &rectC)) {
+	SDL_FRect sensor{
+		.x = obj.position.x + obj.collider.x,
+		.y = obj.position.y + obj.collider.y + obj.collider.h,
+		.w = obj.collider.w,
+		.h = 1
+	};
+	if (hitsLevel && gs.levelGrid.cellRange(sensor, r0, c0, r1, c1)) {
+		for (int r = r0; r <= r1 && !foundGround; r++) {
+			for (int c = c0; c <= c1 && !foundGround; c++) {
+				int colliderIndex = gs.levelGrid.get(r, c);
+				if (colliderIndex != -1) {
+					const uint64_t key = ContactCache::key(bodyRef, colliderIndex);
+					const CachedContact* contact = useCache ? gs.contactCache.find(key) : nullptr;
+					//still body that was standing on this last frame from the same spot is still standing on it
+					if (contact && resting && contact->lastSupport + 1 == gs.contactCache.frame &&
+						sameRect(contact->bodyRect, bodyRect())) {
 						foundGround = true;
 					}
+					else {
+						const GameObject& ground = gs.levelColliders[colliderIndex];
+						SDL_FRect rectB{
+							.x = ground.position.x + ground.collider.x,
+							.y = ground.position.y + ground.collider.y,
+							.w = ground.collider.w,
+							.h = ground.collider.h
+						};
+						SDL_FRect rectC{ 0 };
+						foundGround = SDL_GetRectIntersectionFloat(&sensor, &rectB, &rectC);
+					}
+					if (foundGround && useCache) {
+						gs.contactCache.support(key, bodyRect());
+					}
+				}
+			}
+		}
+	}
+	//losing the ground for a frame without heading up keeps the body grounded for a little bit
+	//so grounded doesnt flicker on and off from float error or crossing from one collider to the next
+	//only while the sensor is still right at the ground it was on though, past the edge it falls
+	if (!foundGround && useCache && hitsLevel && obj.grounded && obj.velocity.y >= 0 &&
+		gs.levelGrid.cellRange(sensor, r0, c0, r1, c1, 1)) {
+		for (int r = r0; r <= r1 && !foundGround; r++) {
+			for (int c = c0; c <= c1 && !foundGround; c++) {
+				const int colliderIndex = gs.levelGrid.get(r, c);
+				const CachedContact* contact = colliderIndex != -1 ?
+					gs.contactCache.find(ContactCache::key(bodyRef, colliderIndex)) : nullptr;
+				if (contact && contact->lastSupport && gs.contactCache.frame - contact->lastSupport <= GROUND_GRACE_FRAMES) {
+					const GameObject& ground = gs.levelColliders[colliderIndex];
+					const SDL_FRect footing{
+						.x = ground.position.x + ground.collider.x - GROUND_GRACE_SLOP,
+						.y = ground.position.y + ground.collider.y - GROUND_GRACE_SLOP,
+						.w = ground.collider.w + GROUND_GRACE_SLOP * 2,
+						.h = ground.collider.h + GROUND_GRACE_SLOP * 2
+					};
+					SDL_FRect overlap;
+					foundGround = SDL_GetRectIntersectionFloat(&sensor, &footing, &overlap);
 				}
-				
 			}
 		}
 	}
+	//running into other characters happens in narrowphase once everything has moved
 	if (obj.grounded != foundGround) {
 		//switching grounded state
 		obj.grounded = foundGround;
@@ -628,104 +1192,734 @@ void update(const SDLState& state, GameState& gs, Resources& res, GameObject& ob
 			obj.data.player.state = PlayerState::running;
 		}
 	}
+	//enemies that have finished dying or have nobody to chase go to sleep once they have been still for a bit
+	if (obj.type == ObjectType::enemy) {
+		const EnemyData& d = obj.data.enemy;
+		const bool settled = (d.state == EnemyState::dead && obj.currentAnimation == -1) ||
+			(d.state == EnemyState::shambling && obj.acceleration.x == 0);
+		if (settled && obj.grounded && obj.velocity.x == 0 && obj.velocity.y == 0) {
+			if (obj.sleepTimer.step(deltaTime)) {
+				obj.sleeping = true;
+			}
+		}
+		else {
+			obj.sleepTimer.reset();
+		}
+	}
+}
+
+void wake(GameObject& obj) {
+	obj.sleeping = false;
+	obj.sleepTimer.reset();
+}
+
+//push objA back out along one axis, normally whichever one overlaps the least
+void pushOut(const SDL_FRect& rectC, GameObject& objA, bool horizontal) {
+	if (horizontal) {
+		//horizontal collision
+		//check if velocity is greater than 0
+		if (objA.velocity.x > 0) {
+			//object must be to the right
+			objA.position.x -= rectC.w;
+		}
+		else if (objA.velocity.x < 0) {
+			objA.position.x += rectC.w;
+		}
+		//set velocity to 0  to stop movement
+		objA.velocity.x = 0;
+	}
+	else {
+		//vertical collision
+		if (objA.velocity.y > 0) {
+			objA.position.y -= rectC.h;//going down
+		}
+		else if (objA.velocity.y < 0) {
+			objA.position.y += rectC.h;//going up
+		}
+		objA.velocity.y = 0;
+	}
+}
+
+//a bullet that hit something solid stops and plays its hit animation
+void stopBullet(const Resources& res, const SDL_FRect& rectC, GameObject& bullet) {
+	pushOut(rectC, bullet, rectC.w < rectC.h);
+	bullet.velocity *= 0;
+	bullet.data.bullet.state = BulletState::colliding;
+	bullet.texture = res.texBulletHit;
+	bullet.currentAnimation = res.ANIM_BULLET_HIT;
+}
+
+//leaves a mark where a bullet hit the level, cut down to the tile it hit so none of it hangs out into the air
+void stampImpactDecal(GameState& gs, const Resources& res, const SDL_FRect& overlap, int r, int c) {
+	//the benchmarks never load any textures so theres nothing to stamp with
+	if (!res.texBulletHit) {
+		return;
+	}
+	const float size = res.textureHeight(res.texBulletHit);
+	const AtlasRegion* region = res.atlas.find(res.texBulletHit);
+	SDL_Texture* tex = region ? res.atlas.pages[region->page] : res.texBulletHit;
+	const SDL_FRect src = region ? res.atlas.frameRect(*region, 0, size, size) : SDL_FRect{ 0, 0, size, size };
+	const SDL_FRect dst{
+		.x = overlap.x + overlap.w / 2 - size / 2,
+		.y = overlap.y + overlap.h / 2 - size / 2,
+		.w = size,
+		.h = size
+	};
+	gs.decals.stamp(tex, src, dst, gs.tileHealth.cellRect(r, c), DECAL_TINT);
+}
+
+//one handler per pair of object types that actually does something when they touch
+void respondPushOut(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime) {
+	bool horizontal = rectC.w < rectC.h;
+	//level colliders are cut at chunk edges so flat ground can be several colliders side by side
+	//walking onto the next one looks like hitting a wall, unless theres more level right behind the face
+	//the side push would go out through, in which case the face is inside the level and the push goes up or down
+	if (horizontal && objB.type == ObjectType::level && objA.velocity.x != 0) {
+		const float face = objA.velocity.x > 0 ? objB.position.x + objB.collider.x - 0.5f
+			: objB.position.x + objB.collider.x + objB.collider.w + 0.5f;
+		int r, c;
+		if (gs.levelGrid.cellAt(face, rectC.y + rectC.h / 2, r, c) && gs.levelGrid.get(r, c) != -1) {
+			horizontal = false;
+		}
+	}
+	pushOut(rectC, objA, horizontal);
+}
+
+void respondPlayerEnemy(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime) {
+	//this is where you can also add health points from the player and adjust if you feel like it
+	if (objB.data.enemy.state != EnemyState::dead) {
+		objA.velocity = vec2(100, 0) * -objA.direction;
+	}
+}
+
+void respondBulletLevel(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime) {
+	if (objA.data.bullet.state == BulletState::moving) {
+		gs.contactEvents.push_back(ContactEvent{ ContactKind::bulletHitLevel, gs.refOf(objA), gs.refOf(objB), rectC });
+	}
+}
+
+void respondBulletEnemy(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime) {
+	//dont collide with dead enemies
+	if (objA.data.bullet.state == BulletState::moving && objB.data.enemy.state != EnemyState::dead) {
+		gs.contactEvents.push_back(ContactEvent{ ContactKind::bulletHitEnemy, gs.refOf(objA), gs.refOf(objB), rectC });
+	}
 }
 
+//the bullet just stops, nothing happens to the player
+void respondBulletPlayer(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime) {
+	if (objA.data.bullet.state == BulletState::moving) {
+		gs.contactEvents.push_back(ContactEvent{ ContactKind::bulletHitPlayer, gs.refOf(objA), gs.refOf(objB), rectC });
+	}
+}
+
+using CollisionHandler = void(*)(const SDLState& state, GameState& gs, const Resources& res, const SDL_FRect& rectC,
+	GameObject& objA, GameObject& objB, float deltaTime);
+
+//which handler runs when objA of one type runs into objB of another, null means nothing happens
+constexpr CollisionHandler pickHandler(ObjectType a, ObjectType b) {
+	if (a == ObjectType::player && b == ObjectType::level) return respondPushOut;
+	if (a == ObjectType::player && b == ObjectType::enemy) return respondPlayerEnemy;
+	if (a == ObjectType::enemy && b == ObjectType::level) return respondPushOut;
+	if (a == ObjectType::enemy && b == ObjectType::enemy) return respondPushOut;
+	if (a == ObjectType::bullet && b == ObjectType::level) return respondBulletLevel;
+	if (a == ObjectType::bullet && b == ObjectType::enemy) return respondBulletEnemy;
+	if (a == ObjectType::bullet && b == ObjectType::player) return respondBulletPlayer;
+	return nullptr;
+}
+
+//the whole type by type table gets built by the compiler so responding is just an index instead of nested switches
+constexpr array<array<CollisionHandler, OBJECT_TYPE_COUNT>, OBJECT_TYPE_COUNT> buildCollisionHandlers() {
+	array<array<CollisionHandler, OBJECT_TYPE_COUNT>, OBJECT_TYPE_COUNT> table{};
+	for (int a = 0; a < OBJECT_TYPE_COUNT; a++) {
+		for (int b = 0; b < OBJECT_TYPE_COUNT; b++) {
+			table[a][b] = pickHandler(static_cast<ObjectType>(a), static_cast<ObjectType>(b));
+		}
+	}
+	return table;
+}
+constexpr auto COLLISION_HANDLERS = buildCollisionHandlers();
+
+//a pair the masks let through with no handler is wasted work, a handler the masks filter out never runs
+constexpr bool masksMatchHandlers() {
+	for (int a = 0; a < OBJECT_TYPE_COUNT; a++) {
+		for (int b = 0; b < OBJECT_TYPE_COUNT; b++) {
+			const bool tested = defaultMaskOf(static_cast<ObjectType>(a)) & categoryOf(static_cast<ObjectType>(b));
+			if (tested != (COLLISION_HANDLERS[a][b] != nullptr)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+static_assert(masksMatchHandlers(), "collision masks and handler table disagree");
+
 void collisionResponse(const SDLState& state, GameState& gs, const Resources& res, 
 	const SDL_FRect &rectA, const SDL_FRect& rectB, const SDL_FRect& rectC, 
 	GameObject& objA, GameObject& objB, float deltaTime) {
-	const auto genericResponse = [&]() {
-		if (rectC.w < rectC.h) {
-			//horizontal collision
-			//check if velocity is greater than 0
-			if (objA.velocity.x > 0) {
-				//object must be to the right
-				objA.position.x -= rectC.w;
-			}
-			else if (objA.velocity.x < 0) {
-				objA.position.x += rectC.w;
+	//getting bumped wakes a sleeping body, dead ones have nothing to do so they stay asleep
+	if (objB.sleeping && !(objB.type == ObjectType::enemy && objB.data.enemy.state == EnemyState::dead)) {
+		gs.contactEvents.push_back(ContactEvent{ ContactKind::wake, gs.refOf(objA), gs.refOf(objB), rectC });
+	}
+	const CollisionHandler handler = COLLISION_HANDLERS[static_cast<int>(objA.type)][static_cast<int>(objB.type)];
+	if (handler) {
+		gs.physicsStats.resolvedContacts++;
+		handler(state, gs, res, rectC, objA, objB, deltaTime);
+	}
+}
+
+//knocks an enemy back, flashes it and takes off some health, killing it if theres none left
+void damageEnemy(const Resources& res, GameObject& enemy, float hitDirection) {
+	EnemyData& d = enemy.data.enemy;
+	wake(enemy);
+	enemy.direction = -hitDirection;
+	enemy.shouldFlash = true;
+	enemy.flashTimer.reset();
+	enemy.texture = res.texEnemyHit;
+	enemy.currentAnimation = res.ANIM_ENEMY_HIT;
+	d.state = EnemyState::damaged;
+	//damage the enemy and flag dead if needed
+	d.healthPoints -= 10;
+	if (d.healthPoints <= 0) {
+		d.state = EnemyState::dead;
+		enemy.texture = res.texEnemyDie;
+		enemy.currentAnimation = res.ANIM_ENEMY_DIE;
+	}
+}
+
+//goes through the contacts in the order they were found, each one checks the state again first
+//since an earlier event this frame may already have stopped the bullet or killed the enemy
+void applyContactEvents(const SDLState& state, GameState& gs, const Resources& res) {
+	for (const ContactEvent& event : gs.contactEvents) {
+		GameObject& objA = gs.resolve(event.a);
+		GameObject& objB = gs.resolve(event.b);
+		switch (event.kind) {
+		case ContactKind::wake:
+			if (!(objB.type == ObjectType::enemy && objB.data.enemy.state == EnemyState::dead)) {
+				wake(objB);
 			}
-			//set velocity to 0  to stop movement
-			objA.velocity.x = 0;
-		}
-		else {
-			//vertical collision
-			if (objA.velocity.y > 0) {
-				objA.position.y -= rectC.h;//going down
+			break;
+		case ContactKind::bulletHitLevel:
+			if (objA.data.bullet.state == BulletState::moving) {
+				//the middle of the overlap is inside the tile that got hit
+				int r, c;
+				const bool inCell = gs.levelTileGrid.cellAt(event.overlap.x + event.overlap.w / 2, event.overlap.y + event.overlap.h / 2, r, c);
+				//an earlier bullet this frame may have shot the tile out already, then theres nothing left to stop this one
+				//or to put a mark on, so it carries on through where the tile was
+				if (inCell && gs.levelTileGrid.get(r, c) == -1) {
+					break;
+				}
+				stopBullet(res, event.overlap, objA);
+				if (inCell) {
+					stampImpactDecal(gs, res, event.overlap, r, c);
+					if (gs.tileHealth.get(r, c) > 0) {
+						gs.tileHealth.set(r, c, gs.tileHealth.get(r, c) - BULLET_TILE_DAMAGE);
+						if (gs.tileHealth.get(r, c) <= 0) {
+							setLevelTile(gs, res, r, c, 0);
+						}
+					}
+				}
 			}
-			else if (objA.velocity.y < 0) {
-				objA.position.y += rectC.h;//going up
+			break;
+		case ContactKind::bulletHitEnemy:
+			if (objA.data.bullet.state == BulletState::moving && objB.data.enemy.state != EnemyState::dead) {
+				damageEnemy(res, objB, objA.direction);
+				stopBullet(res, event.overlap, objA);
 			}
-			objA.velocity.y = 0;
-		}
-	};
-	//first check the type of object A
-	if (objA.type == ObjectType::player) {
-		//object its colliding with
-		switch (objB.type) {
-		case ObjectType::level: {
-			genericResponse();
 			break;
+		case ContactKind::bulletHitPlayer:
+			if (objA.data.bullet.state == BulletState::moving) {
+				stopBullet(res, event.overlap, objA);
 			}
-		case ObjectType::enemy: {
-			//this is where you can also add health points from the player and adjust if you feel like it
+			break;
+		case ContactKind::shotHitEnemy:
 			if (objB.data.enemy.state != EnemyState::dead) {
-				objA.velocity = vec2(100, 0) * -objA.direction;
+				damageEnemy(res, objB, objA.direction);
 			}
-			
 			break;
+		}
+	}
+	gs.contactEvents.clear();
+}
+
+//packs where every character is for the batch kernel, has to be called once the characters are done moving
+void packCharacterBoxes(GameState& gs) {
+	gs.characterBoxes.clear();
+	for (const GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS]) {
+		gs.characterBoxes.push(SDL_FRect{
+			.x = obj.position.x + obj.collider.x,
+			.y = obj.position.y + obj.collider.y,
+			.w = obj.collider.w,
+			.h = obj.collider.h
+		}, obj.collisionCategory);
+	}
+}
+
+//earliest time of impact over this frames move against the level and anything else that would stop the body
+//the level comes from the cells the whole move passes over, bullets also check the packed character boxes
+float sweepMove(GameState& gs, const GameObject& obj, vec2 step) {
+	float earliest = numeric_limits<float>::infinity();
+	const SDL_FRect rectA{
+		.x = obj.position.x + obj.collider.x,
+		.y = obj.position.y + obj.collider.y,
+		.w = obj.collider.w,
+		.h = obj.collider.h
+	};
+	const SDL_FRect swept{
+		.x = min(rectA.x, rectA.x + step.x),
+		.y = min(rectA.y, rectA.y + step.y),
+		.w = rectA.w + abs(step.x),
+		.h = rectA.h + abs(step.y)
+	};
+	int r0, c0, r1, c1;
+	if ((obj.collisionMask & categoryOf(ObjectType::level)) && gs.levelGrid.cellRange(swept, r0, c0, r1, c1)) {
+		for (int r = r0; r <= r1; r++) {
+			for (int c = c0; c <= c1; c++) {
+				const int colliderIndex = gs.levelGrid.get(r, c);
+				if (colliderIndex != -1 && gs.levelGrid.firstInRange(r, c, r0, c0)) {
+					const GameObject& level = gs.levelColliders[colliderIndex];
+					const SDL_FRect rectB{
+						.x = level.position.x + level.collider.x,
+						.y = level.position.y + level.collider.y,
+						.w = level.collider.w,
+						.h = level.collider.h
+					};
+					earliest = min(earliest, sweptAabb(rectA, step.x, step.y, rectB));
+				}
 			}
 		}
-		
 	}
-	else if (objA.type == ObjectType::bullet) {
-		bool passThrough = false;
-		switch (objA.data.bullet.state) {
-			case BulletState::moving :
-				//handling when various objects are hit
-				switch (objB.type) {
-					case ObjectType::level:
-						break;
-					case ObjectType::enemy:
-						EnemyData &d = objB.data.enemy;
-						if (d.state != EnemyState::dead) {
-							objB.direction = -objA.direction;
-							objB.shouldFlash = true;
-							objB.flashTimer.reset();
-							objB.texture = res.texEnemyHit;
-							objB.currentAnimation = res.ANIM_ENEMY_HIT;
-							d.state = EnemyState::damaged;
-							//damage the enemy and flag dead if needed
-							d.healthPoints -= 10;
-							if (d.healthPoints <= 0) {
-								d.state = EnemyState::dead;
-								objB.texture = res.texEnemyDie;
-								objB.currentAnimation = res.ANIM_ENEMY_DIE;
-							}
-						}
-						else {
-							//dont collide with dead enemies
-							passThrough = true;
-						}
-						
-						break;
+	//bullets stop on live enemies too, dead ones get passed through
+	if (obj.type == ObjectType::bullet && gs.characterBoxes.count) {
+		NarrowphaseScratch& scratch = gs.sweepScratch;
+		const vector<GameObject>& characters = gs.layers[LAYER_IDX_CHARACTERS];
+		gs.characterBoxes.candidatesFor(obj.collisionMask & categoryOf(ObjectType::enemy), scratch.candidates);
+		intersectBatch(swept, gs.characterBoxes, scratch.hits, &scratch.candidates);
+		gs.physicsStats.narrowphaseTests += scratch.hits.tested;
+		for (size_t word = 0; word < scratch.hits.mask.size(); word++) {
+			for (uint32_t bits = scratch.hits.mask[word]; bits; bits &= bits - 1) {
+				const int i = static_cast<int>(word * 32 + countr_zero(bits));
+				if (characters[i].data.enemy.state != EnemyState::dead) {
+					earliest = min(earliest, sweptAabb(rectA, step.x, step.y, gs.characterBoxes.rect(i)));
 				}
-				if (!passThrough) {
-					genericResponse();
-					objA.velocity *= 0;
-					objA.data.bullet.state = BulletState::colliding;
-					objA.texture = res.texBulletHit;
-					objA.currentAnimation = res.ANIM_BULLET_HIT;
+			}
+		}
+	}
+	return earliest;
+}
+
+//casts the ray for every hitscan shot fired this frame, one ray through the level grid and the character boxes
+//stops at the nearest thing it reaches and queues the enemy hit like a bullet hit so damage lands in applyContactEvents
+void fireHitscanShots(GameState& gs) {
+	const vector<GameObject>& characters = gs.layers[LAYER_IDX_CHARACTERS];
+	NarrowphaseScratch& scratch = gs.sweepScratch;
+	//shots hit the same things bullets do
+	const uint8_t mask = defaultMaskOf(ObjectType::bullet);
+	for (const HitscanShot& shot : gs.hitscanShots) {
+		const vec2 o = shot.origin, d = shot.direction;
+		float nearest = HITSCAN_RANGE;
+		float levelDist;
+		if ((mask & categoryOf(ObjectType::level)) &&
+			raycastGrid(gs.levelGrid, o.x, o.y, d.x, d.y, HITSCAN_RANGE, levelDist) != -1) {
+			nearest = levelDist;
+		}
+		//only boxes inside the bounds of what the ray covers need the exact test
+		const vec2 end = o + d * nearest;
+		const SDL_FRect bounds{
+			.x = min(o.x, end.x),
+			.y = min(o.y, end.y),
+			.w = abs(end.x - o.x),
+			.h = abs(end.y - o.y)
+		};
+		gs.characterBoxes.candidatesFor(mask & categoryOf(ObjectType::enemy), scratch.candidates);
+		intersectBatch(bounds, gs.characterBoxes, scratch.hits, &scratch.candidates);
+		gs.physicsStats.narrowphaseTests += scratch.hits.tested;
+		int target = -1;
+		for (size_t word = 0; word < scratch.hits.mask.size(); word++) {
+			for (uint32_t bits = scratch.hits.mask[word]; bits; bits &= bits - 1) {
+				const int i = static_cast<int>(word * 32 + countr_zero(bits));
+				float dist;
+				if (characters[i].data.enemy.state != EnemyState::dead &&
+					rayVsRect(o.x, o.y, d.x, d.y, gs.characterBoxes.rect(i), nearest, dist) &&
+					(target == -1 || dist < nearest)) {
+					nearest = dist;
+					target = i;
 				}
-				
+			}
+		}
+		const vec2 hitPoint = o + d * nearest;
+		if (target != -1) {
+			gs.contactEvents.push_back(ContactEvent{
+				ContactKind::shotHitEnemy,
+				shot.shooter,
+				ObjectRef{ ObjectList::characters, static_cast<uint32_t>(target) },
+				SDL_FRect{ hitPoint.x, hitPoint.y, 0, 0 }
+			});
+		}
+		gs.tracers.push_back(Tracer{ o, hitPoint, Timer(TRACER_TIME) });
+	}
+	gs.hitscanShots.clear();
+}
+
+//tests every character and bullet against all the characters
+//the tests only read the game state so they get split across the workers with each writing its own contact list,
+//then the lists are sorted into the order a single thread would find them and responded to one at a time
+//so the pushes and damage come out exactly the same however many threads there are
+void narrowphase(const SDLState& state, GameState& gs, const Resources& res, WorkerPool& workers, float deltaTime) {
+	vector<GameObject>& characters = gs.layers[LAYER_IDX_CHARACTERS];
+	const int characterCount = static_cast<int>(characters.size());
+	const int initiatorCount = characterCount + static_cast<int>(gs.bullets.size());
+	gs.narrowphaseScratch.resize(workers.size());
+	//every list gets cleared even when only the first is used so nothing from an earlier frame gets merged in
+	for (NarrowphaseScratch& scratch : gs.narrowphaseScratch) {
+		scratch.contacts.clear();
+		scratch.candidateCount = 0;
+		scratch.testCount = 0;
+	}
+	const auto testRange = [&](int begin, int end, int worker) {
+		NarrowphaseScratch& scratch = gs.narrowphaseScratch[worker];
+		for (int i = begin; i < end; i++) {
+			const GameObject& obj = i < characterCount ? characters[i] : gs.bullets[i - characterCount];
+			//sleeping and dead bodies and spent bullets dont start collisions
+			if (obj.sleeping || !obj.collisionMask ||
+				(obj.type == ObjectType::enemy && obj.data.enemy.state == EnemyState::dead) ||
+				(obj.type == ObjectType::bullet && obj.data.bullet.state == BulletState::inactive)) {
+				continue;
+			}
+			const SDL_FRect rectA{
+				.x = obj.position.x + obj.collider.x,
+				.y = obj.position.y + obj.collider.y,
+				.w = obj.collider.w,
+				.h = obj.collider.h
+			};
+			gs.characterBoxes.candidatesFor(obj.collisionMask, scratch.candidates);
+			for (uint32_t word : scratch.candidates) {
+				scratch.candidateCount += popcount(word);
+			}
+			//a character never gets tested against itself
+			if (i < characterCount && ((scratch.candidates[i / 32] >> (i % 32)) & 1u)) {
+				scratch.candidateCount--;
+			}
+			intersectBatch(rectA, gs.characterBoxes, scratch.hits, &scratch.candidates);
+			scratch.testCount += scratch.hits.tested;
+			for (size_t word = 0; word < scratch.hits.mask.size(); word++) {
+				for (uint32_t bits = scratch.hits.mask[word]; bits; bits &= bits - 1) {
+					const int target = static_cast<int>(word * 32 + countr_zero(bits));
+					if (target != i) {
+						scratch.contacts.push_back(PairContact{ static_cast<uint32_t>(i), static_cast<uint32_t>(target) });
+					}
+				}
+			}
+		}
+	};
+	if (initiatorCount < NARROWPHASE_PARALLEL_MIN) {
+		testRange(0, initiatorCount, 0);
+	}
+	else {
+		workers.parallelFor(initiatorCount, testRange);
+	}
+	gs.pairContacts.clear();
+	for (const NarrowphaseScratch& scratch : gs.narrowphaseScratch) {
+		gs.pairContacts.insert(gs.pairContacts.end(), scratch.contacts.begin(), scratch.contacts.end());
+		gs.physicsStats.broadphaseCandidates += scratch.candidateCount;
+		gs.physicsStats.narrowphaseTests += scratch.testCount;
+	}
+	sort(gs.pairContacts.begin(), gs.pairContacts.end(), [](const PairContact& a, const PairContact& b) {
+		return a.initiator != b.initiator ? a.initiator < b.initiator : a.target < b.target;
+	});
+	//earlier responses can push things apart so each pair gets checked again from where they are now
+	for (const PairContact& contact : gs.pairContacts) {
+		GameObject& objA = contact.initiator < static_cast<uint32_t>(characterCount) ? characters[contact.initiator]
+			: gs.bullets[contact.initiator - characterCount];
+		checkCollision(state, gs, res, objA, characters[contact.target], deltaTime);
+	}
+}
+
+//fills a long level with enemies and bullets and times the narrowphase on one thread against the whole pool
+//both start from the same copy of the game state and have to end up identical down to the bit
+int runNarrowphaseBenchmark(int enemyCount, int bulletCount, int iterations) {
+	SDLState state;
+	state.logW = 640;
+	state.logH = 320;
+	Resources res;
+	GameState start(state);
+	SDL_srand(1234);
+	const float levelWidth = 4000;
+	for (int i = 0; i <= enemyCount; i++) {
+		GameObject o;
+		//the first one is the player so the game state has one like it expects
+		o.type = i == 0 ? ObjectType::player : ObjectType::enemy;
+		if (o.type == ObjectType::player) {
+			o.data.player = PlayerData();
+			start.playerIndex = 0;
+		}
+		else {
+			o.data.enemy = EnemyData();
+		}
+		o.collisionCategory = categoryOf(o.type);
+		o.collisionMask = defaultMaskOf(o.type);
+		o.position = vec2(static_cast<float>(SDL_rand(static_cast<int>(levelWidth))), static_cast<float>(160 + SDL_rand(100)));
+		o.velocity = vec2(static_cast<float>(SDL_rand(60) - 30), 0);
+		o.collider = SDL_FRect{ .x = 10, .y = 4, .w = 12, .h = 28 };
+		o.dynamic = true;
+		start.layers[LAYER_IDX_CHARACTERS].push_back(o);
+	}
+	for (int i = 0; i < bulletCount; i++) {
+		GameObject b;
+		b.type = ObjectType::bullet;
+		b.data.bullet = BulletData();
+		b.collisionCategory = categoryOf(b.type);
+		b.collisionMask = defaultMaskOf(b.type);
+		b.position = vec2(static_cast<float>(SDL_rand(static_cast<int>(levelWidth))), static_cast<float>(160 + SDL_rand(128)));
+		b.velocity = vec2(SDL_rand(2) ? 600.0f : -600.0f, 0);
+		b.direction = b.velocity.x > 0 ? 1.0f : -1.0f;
+		b.collider = SDL_FRect{ .x = 0, .y = 0, .w = 4, .h = 4 };
+		start.bullets.push_back(b);
+	}
+
+	const auto timeRuns = [&](WorkerPool& workers, GameState& gs) {
+		Uint64 begin = SDL_GetPerformanceCounter();
+		for (int i = 0; i < iterations; i++) {
+			packCharacterBoxes(gs);
+			narrowphase(state, gs, res, workers, 1 / 60.0f);
+			applyContactEvents(state, gs, res);
+		}
+		return secondsSince(begin);
+	};
+	WorkerPool serialPool(0);
+	WorkerPool parallelPool(max(1, SDL_GetNumLogicalCPUCores()) - 1);
+	GameState serial = start;
+	GameState parallel = start;
+	const double serialTime = timeRuns(serialPool, serial);
+	const double parallelTime = timeRuns(parallelPool, parallel);
+
+	const auto sameBits = [](const vector<GameObject>& a, const vector<GameObject>& b) {
+		for (size_t i = 0; i < a.size(); i++) {
+			if (memcmp(&a[i].position, &b[i].position, sizeof(vec2)) != 0 ||
+				memcmp(&a[i].velocity, &b[i].velocity, sizeof(vec2)) != 0 ||
+				a[i].texture != b[i].texture || a[i].currentAnimation != b[i].currentAnimation) {
+				return false;
+			}
+		}
+		return true;
+	};
+	bool identical = sameBits(serial.layers[LAYER_IDX_CHARACTERS], parallel.layers[LAYER_IDX_CHARACTERS]) &&
+		sameBits(serial.bullets, parallel.bullets);
+	for (size_t i = 1; i < serial.layers[LAYER_IDX_CHARACTERS].size(); i++) {
+		identical = identical && serial.layers[LAYER_IDX_CHARACTERS][i].data.enemy.healthPoints ==
+			parallel.layers[LAYER_IDX_CHARACTERS][i].data.enemy.healthPoints;
+	}
+
+	SDL_Log("narrowphase: %d characters, %d bullets, %d frames", enemyCount + 1, bulletCount, iterations);
+	SDL_Log("narrowphase: serial   %.3f ms/frame", serialTime * 1000 / iterations);
+	SDL_Log("narrowphase: %d workers %.3f ms/frame (%.2fx)", parallelPool.size(), parallelTime * 1000 / iterations,
+		serialTime / parallelTime);
+	SDL_Log("narrowphase: results %s", identical ? "identical" : "DIFFERENT");
+	return identical ? 0 : 1;
+}
+
+//times drawFrame against the real renderer and against the null backend with the camera panning across the level
+//the null run is only our own drawing code, the difference between the two is what SDL and the gpu cost
+int runRenderBenchmark(int frames) {
+	SDLState state;
+	state.width = 1600;
+	state.height = 900;
+	state.logW = 640;
+	state.logH = 320;
+	if (!initialize(state)) {
+		return 1;
+	}
+	//vsync would just measure the refresh rate
+	SDL_SetRenderVSync(state.renderer, 0);
+	Resources res;
+	res.load(state);
+	SdlRenderBackend sdlBackend(state.renderer);
+	NullRenderBackend nullBackend(state.renderer);
+	WorkerPool workers(max(1, SDL_GetNumLogicalCPUCores()) - 1);
+	SoftwareRenderBackend softwareBackend(state.renderer, state.logW, state.logH, workers);
+	res.addSources(softwareBackend);
+	for (RenderBackend* backend : { static_cast<RenderBackend*>(&sdlBackend), static_cast<RenderBackend*>(&nullBackend),
+		static_cast<RenderBackend*>(&softwareBackend) }) {
+		state.backend = backend;
+		GameState gs(state);
+		createTiles(state, gs, res);
+		initBackdrop(gs, res);
+		const float panRange = MAP_COLS * TILE_SIZE - gs.mapViewport.w;
+		const Uint64 start = SDL_GetPerformanceCounter();
+		for (int i = 0; i < frames; i++) {
+			//back and forth so the chunks and culling see the whole level
+			const float t = fmod(i * 4.0f, panRange * 2);
+			gs.mapViewport.x = t < panRange ? t : panRange * 2 - t;
+			drawFrame(state, gs, res, 1 / 60.0f);
+			backend->present();
+		}
+		const double elapsed = secondsSince(start);
+		SDL_Log("render: %-8s %.3f ms/frame, last frame %d calls %d vertices %d state changes", backend->name(),
+			elapsed * 1000 / frames, backend->counters.drawCalls, backend->counters.vertices, backend->counters.stateChanges);
+		gs.destroyRenderTargets(*state.backend);
+	}
+	res.unload();
+	cleanup(state);
+	return 0;
+}
+
+//renders a fixed run of scripted frames with sdls software renderer into a surface, no window or gpu needed
+//each frame is hashed and checked against data/golden/hashes.txt so a drawing change that should look the same
+//can be shown to be pixel identical, every IMAGE_STRIDE frames the reference is kept as a bmp as well
+//so a frame that fails can be put next to what it should look like
+//record writes the set out instead, do that on a known good build, checking without a set fails
+//the render time of every frame goes to golden_times.csv so one slow frame doesnt get lost in the average
+int runGoldenFrames(bool record) {
+	const int FRAMES = 240;
+	const int IMAGE_STRIDE = 30;
+	const char* GOLDEN_DIR = "data/golden";
+	const string hashPath = format("{}/hashes.txt", GOLDEN_DIR);
+	const char* TIMES_PATH = "golden_times.csv";
+	//what the player does, held keys stay down until their up
+	struct ScriptedKey {
+		int frame;
+		SDL_Scancode key;
+		bool down;
+	};
+	const ScriptedKey script[] = {
+		{ 30, SDL_SCANCODE_D, true },
+		{ 60, SDL_SCANCODE_K, true },
+		{ 62, SDL_SCANCODE_K, false },
+		{ 90, SDL_SCANCODE_J, true },
+		{ 130, SDL_SCANCODE_J, false },
+		{ 140, SDL_SCANCODE_D, false },
+		{ 140, SDL_SCANCODE_A, true },
+		{ 200, SDL_SCANCODE_A, false },
+		{ 200, SDL_SCANCODE_J, true },
+		{ 230, SDL_SCANCODE_J, false }
+	};
+
+	//a missing set is a failure, recording one here would make every check pass without comparing anything
+	vector<uint64_t> golden;
+	if (!record) {
+		size_t size = 0;
+		char* text = static_cast<char*>(SDL_LoadFile(hashPath.c_str(), &size));
+		if (!text) {
+			SDL_Log("golden: no %s, run with --golden record on a known good build first", hashPath.c_str());
+			return 1;
+		}
+		for (char* line = text; line < text + size; line = strchr(line, '\n') + 1) {
+			golden.push_back(strtoull(line, nullptr, 16));
+			if (!strchr(line, '\n')) {
 				break;
+			}
+		}
+		SDL_free(text);
+	}
+
+	SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "dummy");
+	if (!SDL_Init(SDL_INIT_VIDEO)) {
+		SDL_Log("golden: couldnt start SDL: %s", SDL_GetError());
+		return 1;
+	}
+	SDLState state;
+	state.width = state.logW = 640;
+	state.height = state.logH = 320;
+	state.window = nullptr;
+	SDL_Surface* frame = SDL_CreateSurface(state.logW, state.logH, SDL_PIXELFORMAT_ARGB8888);
+	state.renderer = SDL_CreateSoftwareRenderer(frame);
+	//the keyboard is the script not whatever the real one is doing
+	bool keys[SDL_SCANCODE_COUNT] = {};
+	state.keys = keys;
+	SdlRenderBackend backend(state.renderer);
+	state.backend = &backend;
+	Resources res;
+	res.load(state);
+	GameState gs(state);
+	createTiles(state, gs, res);
+	initBackdrop(gs, res);
+	WorkerPool workers(max(1, SDL_GetNumLogicalCPUCores()) - 1);
+	//bullets spread randomly so the seed has to be the same every run
+	SDL_srand(1234);
+
+	if (record && !SDL_CreateDirectory(GOLDEN_DIR)) {
+		SDL_Log("golden: couldnt make %s: %s", GOLDEN_DIR, SDL_GetError());
+	}
+
+	const float deltaTime = 1 / 60.0f;
+	string hashes;
+	string times = "frame,ms,hash\n";
+	vector<double> frameTimes;
+	int mismatches = 0;
+	bool ok = true;
+	for (int i = 0; i < FRAMES; i++) {
+		for (const ScriptedKey& event : script) {
+			if (event.frame == i) {
+				keys[event.key] = event.down;
+				handleKeyInput(state, gs, gs.player(), event.key, event.down);
+			}
+		}
+		stepFrame(state, gs, res, workers, deltaTime);
+		//only the drawing is timed, flushing is where the software renderer actually fills the pixels
+		const Uint64 start = SDL_GetPerformanceCounter();
+		drawFrame(state, gs, res, deltaTime);
+		SDL_FlushRenderer(state.renderer);
+		const double elapsed = secondsSince(start);
+		frameTimes.push_back(elapsed);
+
+		const uint64_t hash = hashPixels(frame);
+		hashes += format("{:016x}\n", hash);
+		times += format("{},{:.3f},{:016x}\n", i, elapsed * 1000, hash);
+		const string reference = format("{}/frame_{:03}.bmp", GOLDEN_DIR, i);
+		if (record && i % IMAGE_STRIDE == 0) {
+			ok = SDL_SaveBMP(frame, reference.c_str()) && ok;
+		}
+		if (!record && i < static_cast<int>(golden.size()) && golden[i] != hash) {
+			//keep the frame that changed so it can be looked at
+			mismatches++;
+			const string path = format("golden_fail_{:03}.bmp", i);
+			SDL_SaveBMP(frame, path.c_str());
+			const string note = i % IMAGE_STRIDE == 0 ? ", reference is " + reference : "";
+			SDL_Log("golden: frame %d is %016llx, expected %016llx, saved %s%s", i,
+				static_cast<unsigned long long>(hash), static_cast<unsigned long long>(golden[i]), path.c_str(), note.c_str());
 		}
 	}
-	else if (objA.type == ObjectType::enemy) {
-		genericResponse();
+
+	//sorted copy for the median and the slow tail, the per frame list in the csv stays in frame order
+	vector<double> sorted = frameTimes;
+	sort(sorted.begin(), sorted.end());
+	double total = 0;
+	for (double elapsed : frameTimes) {
+		total += elapsed;
 	}
+	SDL_Log("golden: %d frames, render ms/frame average %.3f, median %.3f, 95th %.3f, fastest %.3f, slowest %.3f",
+		FRAMES, total * 1000 / FRAMES, sorted[FRAMES / 2] * 1000, sorted[FRAMES * 95 / 100] * 1000,
+		sorted.front() * 1000, sorted.back() * 1000);
+	if (SDL_SaveFile(TIMES_PATH, times.data(), times.size())) {
+		SDL_Log("golden: per frame times are in %s", TIMES_PATH);
+	}
+	if (record) {
+		ok = SDL_SaveFile(hashPath.c_str(), hashes.data(), hashes.size()) && ok;
+		SDL_Log("golden: wrote %s and every %dth frame as a bmp next to it", hashPath.c_str(), IMAGE_STRIDE);
+	}
+	else {
+		ok = static_cast<int>(golden.size()) == FRAMES && mismatches == 0;
+		SDL_Log("golden: %d of %d frames differ%s", mismatches, FRAMES,
+			static_cast<int>(golden.size()) == FRAMES ? "" : ", golden file doesnt match the frame count");
+	}
+	gs.destroyRenderTargets(*state.backend);
+	res.unload();
+	SDL_DestroyRenderer(state.renderer);
+	SDL_DestroySurface(frame);
+	SDL_Quit();
+	return ok ? 0 : 1;
 }
 
-void checkCollision(const SDLState& state, GameState& gs, const Resources& res, GameObject& a, GameObject& b, float deltaTime) {
+//returns whether the two were overlapping
+bool checkCollision(const SDLState& state, GameState& gs, const Resources& res, GameObject& a, GameObject& b, float deltaTime) {
+	//pairs the masks say never do anything dont even get their rects compared
+	if (!(a.collisionMask & b.collisionCategory)) {
+		return false;
+	}
 	SDL_FRect rectA{
 		.x = a.position.x + a.collider.x,
 		.y = a.position.y + a.collider.y,
@@ -740,11 +1934,16 @@ void checkCollision(const SDLState& state, GameState& gs, const Resources& res,
 		.h = b.collider.h
 	};
 	SDL_FRect rectC{ 0 };
+	gs.physicsStats.narrowphaseTests++;
+	gs.heatmap.add(rectA.x + rectA.w / 2, rectA.y + rectA.h / 2);
 	//pass in the first two and then the result gets passed to c
 	if (SDL_GetRectIntersectionFloat(&rectA, &rectB, &rectC)) {
+		gs.physicsStats.hits++;
 		//if its true its an intersection, respond accordingly
 		collisionResponse(state, gs, res, rectA, rectB, rectC, a, b,deltaTime);
+		return true;
 	}
+	return false;
 }
 
 void createTiles(const SDLState &state, GameState &gs, const Resources &res) 
@@ -786,6 +1985,8 @@ void createTiles(const SDLState &state, GameState &gs, const Resources &res)
 			const auto createObject = [&state](int r, int c, SDL_Texture* tex, ObjectType type) {
 				GameObject o;
 				o.type = type;
+				o.collisionCategory = categoryOf(type);
+				o.collisionMask = defaultMaskOf(type);
 				//subtract tile height from the floor need to subtract to avoid being inverted.
 				o.position = vec2(c * TILE_SIZE, state.logH - (MAP_ROWS - r) * TILE_SIZE);
 				o.texture = tex;
@@ -804,11 +2005,14 @@ void createTiles(const SDLState &state, GameState &gs, const Resources &res)
 					case 1: {//ground case
 						GameObject o = createObject(r, c, res.texGround, ObjectType::level);
 						gs.layers[LAYER_IDX_LEVEL].push_back(o);
+						gs.levelTileGrid.set(r, c, static_cast<int>(gs.layers[LAYER_IDX_LEVEL].size() - 1));
 						break;
 					}
 					case 2: {//Panel case
 						GameObject o = createObject(r, c, res.texPanel, ObjectType::level);
 						gs.layers[LAYER_IDX_LEVEL].push_back(o);
+						gs.levelTileGrid.set(r, c, static_cast<int>(gs.layers[LAYER_IDX_LEVEL].size() - 1));
+						gs.tileHealth.set(r, c, PANEL_HEALTH);
 						break;
 					}
 					case 3: {//enemy case
@@ -854,11 +2058,13 @@ void createTiles(const SDLState &state, GameState &gs, const Resources &res)
 					case 5: { //grass
 						GameObject o = createObject(r, c, res.texGrass, ObjectType::level);
 						gs.foregroundTiles.push_back(o);
+						gs.foregroundTileGrid.set(r, c, static_cast<int>(gs.foregroundTiles.size() - 1));
 						break;
 						}
 					case 6: { //brick
 						GameObject o = createObject(r, c, res.texBrick, ObjectType::level);
 						gs.backgroundTiles.push_back(o);
+						gs.backgroundTileGrid.set(r, c, static_cast<int>(gs.backgroundTiles.size() - 1));
 						break;
 						}
 					}
@@ -868,11 +2074,137 @@ void createTiles(const SDLState &state, GameState &gs, const Resources &res)
 		loadMap(map);
 		loadMap(background);
 		loadMap(foreground);
+
+		//merge the ground and panel tiles into as few colliders as possible
+		//fewer things to test against and nothing to snag on where two tiles meet
+		for (int chunk = 0; chunk * TILE_CHUNK_COLS < MAP_COLS; chunk++) {
+			rebuildLevelColliders(gs, chunk);
+		}
 		
 		//basically to check to make sure the player was actually created
 		assert(gs.playerIndex != -1);
 	}
 
+//merges the solid tiles in one chunk of columns into colliders, replacing whatever colliders the chunk had
+//colliders never cross a chunk edge so a tile changing only ever means redoing the chunk its in
+void rebuildLevelColliders(GameState& gs, int chunk) {
+	const int c0 = chunk * TILE_CHUNK_COLS;
+	const int c1 = min(MAP_COLS, c0 + TILE_CHUNK_COLS);
+	const int width = c1 - c0;
+	//free the old colliders, every cell of one is inside the chunk so each is freed once at its first cell
+	for (int r = 0; r < MAP_ROWS; r++) {
+		for (int c = c0; c < c1; c++) {
+			const int index = gs.levelGrid.get(r, c);
+			if (index != -1 && gs.levelGrid.firstInRange(r, c, 0, c0)) {
+				gs.contactCache.forgetCollider(index);
+				gs.levelColliders[index].collider = SDL_FRect{ 0 };
+				gs.freeLevelColliders.push_back(index);
+			}
+		}
+	}
+	for (int r = 0; r < MAP_ROWS; r++) {
+		for (int c = c0; c < c1; c++) {
+			gs.levelGrid.set(r, c, -1);
+		}
+	}
+	vector<bool> solid(MAP_ROWS * width);
+	for (int r = 0; r < MAP_ROWS; r++) {
+		for (int c = c0; c < c1; c++) {
+			solid[r * width + c - c0] = gs.levelTileGrid.get(r, c) != -1;
+		}
+	}
+	for (const SDL_Rect& cells : mergeSolidCells(solid, MAP_ROWS, width)) {
+		GameObject o;
+		o.type = ObjectType::level;
+		o.position = vec2(gs.levelGrid.originX + (c0 + cells.x) * TILE_SIZE, gs.levelGrid.originY + cells.y * TILE_SIZE);
+		o.collider = SDL_FRect{
+			.x = 0,
+			.y = 0,
+			.w = static_cast<float>(cells.w * TILE_SIZE),
+			.h = static_cast<float>(cells.h * TILE_SIZE)
+		};
+		int index;
+		if (!gs.freeLevelColliders.empty()) {
+			index = gs.freeLevelColliders.back();
+			gs.freeLevelColliders.pop_back();
+			gs.levelColliders[index] = o;
+		}
+		else {
+			gs.levelColliders.push_back(o);
+			index = static_cast<int>(gs.levelColliders.size() - 1);
+		}
+		for (int r = cells.y; r < cells.y + cells.h; r++) {
+			for (int c = c0 + cells.x; c < c0 + cells.x + cells.w; c++) {
+				gs.levelGrid.set(r, c, index);
+			}
+		}
+	}
+}
+
+//changes one cell of the level, 0 removes whatever is there, 1 is ground and 2 is a panel
+//only the chunk holding the cell gets baked again and has its colliders redone so the cost doesnt grow with the map
+void setLevelTile(GameState& gs, const Resources& res, int r, int c, int type) {
+	vector<GameObject>& tiles = gs.layers[LAYER_IDX_LEVEL];
+	const int old = gs.levelTileGrid.get(r, c);
+	if (old != -1) {
+		tiles[old].texture = nullptr;
+		gs.freeLevelTiles.push_back(old);
+		gs.levelTileGrid.set(r, c, -1);
+		gs.tileHealth.set(r, c, -1);
+		//any marks on the old tile go with it
+		gs.decals.erase(gs.levelTileGrid.cellRect(r, c));
+	}
+	if (type == 1 || type == 2) {
+		GameObject o;
+		o.type = ObjectType::level;
+		o.position = vec2(gs.levelTileGrid.originX + c * TILE_SIZE, gs.levelTileGrid.originY + r * TILE_SIZE);
+		o.texture = type == 1 ? res.texGround : res.texPanel;
+		o.collider = SDL_FRect{
+			.x = 0,
+			.y = 0,
+			.w = TILE_SIZE,
+			.h = TILE_SIZE
+		};
+		int index;
+		if (!gs.freeLevelTiles.empty()) {
+			index = gs.freeLevelTiles.back();
+			gs.freeLevelTiles.pop_back();
+			tiles[index] = o;
+		}
+		else {
+			tiles.push_back(o);
+			index = static_cast<int>(tiles.size() - 1);
+		}
+		gs.levelTileGrid.set(r, c, index);
+		gs.tileHealth.set(r, c, type == 2 ? PANEL_HEALTH : -1);
+	}
+	else if (old == -1) {
+		return;
+	}
+	gs.levelChunks.markDirty(c);
+	rebuildLevelColliders(gs, c / TILE_CHUNK_COLS);
+	//anything asleep on or next to the cell needs to notice the level changed under it
+	//corpses too, otherwise one lying on a tile that gets shot out is left hanging in the air
+	//it just falls, settles and goes back to sleep
+	const SDL_FRect around{
+		.x = gs.levelTileGrid.originX + (c - 1) * TILE_SIZE,
+		.y = gs.levelTileGrid.originY + (r - 1) * TILE_SIZE,
+		.w = TILE_SIZE * 3,
+		.h = TILE_SIZE * 3
+	};
+	for (GameObject& obj : gs.layers[LAYER_IDX_CHARACTERS]) {
+		const SDL_FRect rect{
+			.x = obj.position.x + obj.collider.x,
+			.y = obj.position.y + obj.collider.y,
+			.w = obj.collider.w,
+			.h = obj.collider.h
+		};
+		if (obj.sleeping && SDL_HasRectIntersectionFloat(&rect, &around)) {
+			wake(obj);
+		}
+	}
+}
+
 void handleKeyInput(const SDLState& state, GameState& gs, GameObject& obj, SDL_Scancode key, bool keyDown) {
 	const float JUMP_FORCE = -200.0f;
 	if (obj.type == ObjectType::player) {
@@ -891,22 +2223,4 @@ void handleKeyInput(const SDLState& state, GameState& gs, GameObject& obj, SDL_S
 				break;
 		}
 	}
-}
-
-void drawParralaxBackground(SDL_Renderer* renderer, SDL_Texture* texture, float xVelocity, float& scrollPos, float scrollFactor, float deltaTime) {
-	scrollPos -= xVelocity * scrollFactor * deltaTime;
-	//moves the scroll inverse to player
-	//if the scroll position is greater than the width
-	if (scrollPos <= -texture->w) {
-		scrollPos = 0;
-	}
-	
-	SDL_FRect dst{
-		.x = scrollPos,
-		.y = 30,
-		.w = texture->w * 2.0f,//setting to ortignal  textures width times 2 so it can scroll
-		.h = static_cast<float>(texture->h)
-	};
-	//will allow us to draw the texture twice so we dont need to call it and then it will alays scroll back without user noticing
-	SDL_RenderTextureTiled(renderer, texture, nullptr, 1, &dst);
 }
\ No newline at end of file
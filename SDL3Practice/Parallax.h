@@ -0,0 +1,142 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <SDL3/SDL.h>
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+
+//one backdrop layer, tiled across the screen and scrolled by factor times how fast the player is going
+struct ParallaxLayer {
+	SDL_Texture* texture;
+	float y, w, h;
+	float factor;
+	//always kept between 0 and w since the layer repeats every w pixels anyway
+	float scroll;
+	//whole pixel scroll it was last drawn into the composite at
+	int composedOffset;
+};
+
+//draws all the backdrop layers into one texture and puts that on screen as a single quad while nothing is moving
+//layers only move in whole pixels so when the player stands still last frames composite gets used as is
+//every layer scrolls at its own rate so theres nothing to reuse while moving, then the layers are drawn straight
+//to the screen instead since drawing them into the composite as well would only add a full screen copy
+//the composite is only drawn again once nothing has moved for a few frames, at walking speed the near layer
+//only crosses a pixel every other frame and recomposing in the gaps would cost more than it saves
+class ParallaxCompositor {
+	static constexpr int SETTLE_FRAMES = 8;
+
+	std::vector<ParallaxLayer> layers;
+	SDL_Texture* composite;
+	int width, height;
+	SDL_Color clearColor;
+	bool valid;
+	//whole pixel offset of every layer last frame, to tell whether anything moved since
+	std::vector<int> lastOffsets;
+	//frames in a row no layer has moved
+	int stillFrames;
+
+	static int offsetOf(const ParallaxLayer& layer) {
+		return static_cast<int>(std::floor(layer.scroll));
+	}
+
+	//draws every layer at its whole pixel offset into whatever the batch draws to
+	void drawLayers(SpriteBatch& batch) {
+		for (const ParallaxLayer& layer : layers) {
+			const int offset = offsetOf(layer);
+			const SDL_FRect src{ 0, 0, static_cast<float>(layer.texture->w), static_cast<float>(layer.texture->h) };
+			for (float x = offset - layer.w; x < width; x += layer.w) {
+				if (x + layer.w > 0) {
+					batch.draw(layer.texture, src, SDL_FRect{ x, layer.y, layer.w, layer.h }, false);
+				}
+			}
+		}
+	}
+
+public:
+	//how many times the composite has been drawn and how many frames the layers went straight to the screen
+	int recomposeCount;
+	int directCount;
+
+	ParallaxCompositor() : composite(nullptr), width(0), height(0), clearColor{ 0, 0, 0, 255 },
+		valid(false), stillFrames(0), recomposeCount(0), directCount(0) {}
+	ParallaxCompositor(int width, int height, SDL_Color clearColor) : composite(nullptr),
+		width(width), height(height), clearColor(clearColor), valid(false), stillFrames(0), recomposeCount(0), directCount(0) {}
+
+	//layers are drawn in the order theyre added, a factor of 0 never moves
+	void addLayer(SDL_Texture* texture, float y, float w, float h, float factor) {
+		layers.push_back(ParallaxLayer{ texture, y, w, h, factor, 0, 0 });
+		valid = false;
+	}
+
+	//moves every layer against the players velocity
+	void scroll(float xVelocity, float deltaTime) {
+		for (ParallaxLayer& layer : layers) {
+			layer.scroll = std::fmod(layer.scroll - xVelocity * layer.factor * deltaTime, layer.w);
+			if (layer.scroll < 0) {
+				layer.scroll += layer.w;
+			}
+		}
+	}
+
+	//puts the backdrop on the given layer, through the composite once nothing has moved for SETTLE_FRAMES frames
+	//the backdrop is behind everything so when the layers go straight to the batch they still end up at the back
+	void draw(RenderBackend& backend, SpriteBatch& batch, RenderQueue& queue, RenderLayer renderLayer) {
+		bool moving = lastOffsets.size() != layers.size();
+		bool changed = !valid;
+		lastOffsets.resize(layers.size());
+		for (size_t i = 0; i < layers.size(); i++) {
+			const int offset = offsetOf(layers[i]);
+			moving = moving || offset != lastOffsets[i];
+			changed = changed || offset != layers[i].composedOffset;
+			lastOffsets[i] = offset;
+		}
+		stillFrames = moving ? 0 : std::min(stillFrames + 1, SETTLE_FRAMES);
+		if (changed && stillFrames < SETTLE_FRAMES) {
+			drawLayers(batch);
+			//whats in the composite is out of date now
+			valid = false;
+			directCount++;
+			return;
+		}
+		if (changed) {
+			if (!composite) {
+				composite = SDL_CreateTexture(backend.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+				//without a composite the layers just keep going straight to the screen
+				if (!composite) {
+					drawLayers(batch);
+					directCount++;
+					return;
+				}
+				SDL_SetTextureScaleMode(composite, SDL_SCALEMODE_NEAREST);
+				//the composite is opaque so it just gets copied
+				SDL_SetTextureBlendMode(composite, SDL_BLENDMODE_NONE);
+			}
+			//anything queued belongs to the screen so it has to go out before switching targets
+			batch.flush();
+			SDL_Texture* previous = backend.target();
+			backend.setTarget(composite);
+			backend.setDrawColor(clearColor.r, clearColor.g, clearColor.b, 255);
+			backend.clear();
+			drawLayers(batch);
+			batch.flush();
+			backend.setTarget(previous);
+			for (ParallaxLayer& layer : layers) {
+				layer.composedOffset = offsetOf(layer);
+			}
+			valid = true;
+			recomposeCount++;
+		}
+		queue.sprite(renderLayer, composite, SDL_FRect{ 0, 0, static_cast<float>(width), static_cast<float>(height) },
+			SDL_FRect{ 0, 0, static_cast<float>(width), static_cast<float>(height) }, false);
+	}
+
+	//render target contents can get lost, ie when the device is reset, so it has to be drawn again
+	void invalidate() { valid = false; }
+	void destroy(RenderBackend& backend) {
+		backend.forgetTexture(composite);
+		SDL_DestroyTexture(composite);
+		composite = nullptr;
+		valid = false;
+	}
+};
@@ -0,0 +1,50 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+//counts of what the collision code did in one frame, reset at the start of every frame
+struct PhysicsStats {
+	//pairs that got past the grid and mask filters and were handed on to be tested
+	int broadphaseCandidates;
+	//exact rect tests, counting every lane the batch kernel compared, and how many of the single tests overlapped
+	int narrowphaseTests;
+	int hits;
+	//overlaps that actually had a response to run
+	int resolvedContacts;
+	//level contacts the contact cache answered without testing
+	int cacheHits;
+	int sleepingBodies;
+
+	PhysicsStats() { reset(); }
+	void reset() {
+		broadphaseCandidates = narrowphaseTests = hits = resolvedContacts = cacheHits = sleepingBodies = 0;
+	}
+};
+
+//how many pair tests happened in each part of the map, every cell fades a bit each frame so it shows recent activity
+struct CollisionHeatmap {
+	int rows, cols;
+	float originX, originY, cellSize;
+	std::vector<float> heat;
+
+	CollisionHeatmap() : rows(0), cols(0), originX(0), originY(0), cellSize(1) {}
+	CollisionHeatmap(int rows, int cols, float originX, float originY, float cellSize)
+		: rows(rows), cols(cols), originX(originX), originY(originY), cellSize(cellSize), heat(rows * cols, 0) {}
+
+	void add(float x, float y, float amount = 1) {
+		const int c = static_cast<int>(std::floor((x - originX) / cellSize));
+		const int r = static_cast<int>(std::floor((y - originY) / cellSize));
+		if (r >= 0 && r < rows && c >= 0 && c < cols) {
+			heat[r * cols + c] += amount;
+		}
+	}
+	void decay(float factor) {
+		for (float& h : heat) {
+			h *= factor;
+		}
+	}
+	float peak() const {
+		return heat.empty() ? 0 : *std::max_element(heat.begin(), heat.end());
+	}
+};
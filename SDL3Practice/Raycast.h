@@ -0,0 +1,80 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <utility>
+#include <SDL3/SDL.h>
+#include "TileGrid.h"
+
+//how far along a ray it enters a box, the direction has to be normalized so the distance is in pixels
+//starting inside the box counts as a hit at 0, returns false if it misses or the box is past maxDist
+inline bool rayVsRect(float ox, float oy, float dx, float dy, const SDL_FRect& rect, float maxDist, float& dist) {
+	float tMin = 0, tMax = maxDist;
+	//narrows down the stretch of the ray thats between the two edges on one axis
+	const auto slab = [&tMin, &tMax](float o, float d, float lo, float hi) {
+		if (d == 0) {
+			return o >= lo && o <= hi;
+		}
+		float t0 = (lo - o) / d;
+		float t1 = (hi - o) / d;
+		if (t0 > t1) {
+			std::swap(t0, t1);
+		}
+		tMin = std::max(tMin, t0);
+		tMax = std::min(tMax, t1);
+		return tMin <= tMax;
+	};
+	if (!slab(ox, dx, rect.x, rect.x + rect.w) || !slab(oy, dy, rect.y, rect.y + rect.h)) {
+		return false;
+	}
+	dist = tMin;
+	return true;
+}
+
+//walks the cells a ray passes through in order and stops at the first one that isnt empty
+//each step just moves to whichever grid line the ray reaches next so its one cell per step no matter the angle
+//returns that cells value and how far along the ray it was entered, or -1 if theres nothing within maxDist
+inline int raycastGrid(const TileGrid& grid, float ox, float oy, float dx, float dy, float maxDist, float& dist) {
+	//rays can start outside the grid so skip ahead to where they enter it
+	const SDL_FRect bounds{
+		.x = grid.originX,
+		.y = grid.originY,
+		.w = grid.cols * grid.tileSize,
+		.h = grid.rows * grid.tileSize
+	};
+	float t;
+	if (!rayVsRect(ox, oy, dx, dy, bounds, maxDist, t)) {
+		return -1;
+	}
+	int c = std::clamp(static_cast<int>(std::floor((ox + dx * t - grid.originX) / grid.tileSize)), 0, grid.cols - 1);
+	int r = std::clamp(static_cast<int>(std::floor((oy + dy * t - grid.originY) / grid.tileSize)), 0, grid.rows - 1);
+	const float inf = std::numeric_limits<float>::infinity();
+	const int stepC = dx > 0 ? 1 : -1;
+	const int stepR = dy > 0 ? 1 : -1;
+	//distance along the ray between grid lines on each axis and to the next line it crosses
+	const float deltaC = dx != 0 ? grid.tileSize / std::abs(dx) : inf;
+	const float deltaR = dy != 0 ? grid.tileSize / std::abs(dy) : inf;
+	float nextC = dx != 0 ? (grid.originX + (c + (dx > 0 ? 1 : 0)) * grid.tileSize - ox) / dx : inf;
+	float nextR = dy != 0 ? (grid.originY + (r + (dy > 0 ? 1 : 0)) * grid.tileSize - oy) / dy : inf;
+	while (t <= maxDist) {
+		const int value = grid.get(r, c);
+		if (value != -1) {
+			dist = t;
+			return value;
+		}
+		if (nextC < nextR) {
+			c += stepC;
+			t = nextC;
+			nextC += deltaC;
+		}
+		else {
+			r += stepR;
+			t = nextR;
+			nextR += deltaR;
+		}
+		if (c < 0 || c >= grid.cols || r < 0 || r >= grid.rows) {
+			return -1;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <SDL3/SDL.h>
+
+//what got sent to the backend since the last beginFrame
+struct RenderCounters {
+	int drawCalls;
+	int vertices;
+	int stateChanges;
+};
+
+//everything the game draws with goes through one of these instead of straight to the SDL_Renderer
+//so the same drawing code can either really draw or just be counted, ie to time our own side of drawing on its own
+//textures are still made and loaded on the real renderer either way, only draw calls and draw state go through here
+class RenderBackend {
+	virtual void doGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) = 0;
+	virtual void doFillRects(const SDL_FRect* rects, int count) = 0;
+	virtual void doRects(const SDL_FRect* rects, int count) = 0;
+	virtual void doLine(float x1, float y1, float x2, float y2) = 0;
+	virtual void doDebugText(float x, float y, const char* text) = 0;
+	virtual void doClear() = 0;
+	virtual void doSetDrawColor(SDL_FColor color) = 0;
+	virtual void doSetDrawBlendMode(SDL_BlendMode blend) = 0;
+	virtual void doSetTarget(SDL_Texture* texture) = 0;
+	virtual void doSetClip(const SDL_Rect* clip) = 0;
+	virtual void doSetScale(float x, float y) = 0;
+
+public:
+	SDL_Renderer* renderer;
+	RenderCounters counters;
+
+	explicit RenderBackend(SDL_Renderer* renderer) : renderer(renderer), counters{ 0, 0, 0 } {}
+	virtual ~RenderBackend() = default;
+	RenderBackend(const RenderBackend&) = delete;
+	RenderBackend& operator=(const RenderBackend&) = delete;
+
+	virtual const char* name() const = 0;
+	virtual SDL_Texture* target() const = 0;
+	virtual void present() = 0;
+	//makes sure everything submitted so far has actually been drawn, ie before timing a frame
+	virtual void flush() = 0;
+	//call before destroying a texture that was drawn into so the backend can drop anything it kept for it
+	virtual void forgetTexture(SDL_Texture* texture) = 0;
+
+	void beginFrame() { counters = RenderCounters{ 0, 0, 0 }; }
+
+	void geometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) {
+		counters.drawCalls++;
+		counters.vertices += vertexCount;
+		doGeometry(texture, vertices, vertexCount, indices, indexCount);
+	}
+	void fillRects(const SDL_FRect* rects, int count) {
+		counters.drawCalls++;
+		counters.vertices += count * 4;
+		doFillRects(rects, count);
+	}
+	void fillRect(const SDL_FRect& rect) { fillRects(&rect, 1); }
+	void rects(const SDL_FRect* rects, int count) {
+		counters.drawCalls++;
+		counters.vertices += count * 4;
+		doRects(rects, count);
+	}
+	void line(float x1, float y1, float x2, float y2) {
+		counters.drawCalls++;
+		counters.vertices += 2;
+		doLine(x1, y1, x2, y2);
+	}
+	void debugText(float x, float y, const char* text) {
+		counters.drawCalls++;
+		doDebugText(x, y, text);
+	}
+	void clear() {
+		counters.drawCalls++;
+		doClear();
+	}
+	void setDrawColor(SDL_FColor color) {
+		counters.stateChanges++;
+		doSetDrawColor(color);
+	}
+	void setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+		setDrawColor(SDL_FColor{ r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f });
+	}
+	void setDrawBlendMode(SDL_BlendMode blend) {
+		counters.stateChanges++;
+		doSetDrawBlendMode(blend);
+	}
+	void setTarget(SDL_Texture* texture) {
+		counters.stateChanges++;
+		doSetTarget(texture);
+	}
+	void setClip(const SDL_Rect* clip) {
+		counters.stateChanges++;
+		doSetClip(clip);
+	}
+	void setScale(float x, float y) {
+		counters.stateChanges++;
+		doSetScale(x, y);
+	}
+};
+
+//passes everything on to the SDL_Renderer
+class SdlRenderBackend : public RenderBackend {
+	void doGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) override {
+		SDL_RenderGeometry(renderer, texture, vertices, vertexCount, indices, indexCount);
+	}
+	void doFillRects(const SDL_FRect* rects, int count) override { SDL_RenderFillRects(renderer, rects, count); }
+	void doRects(const SDL_FRect* rects, int count) override { SDL_RenderRects(renderer, rects, count); }
+	void doLine(float x1, float y1, float x2, float y2) override { SDL_RenderLine(renderer, x1, y1, x2, y2); }
+	void doDebugText(float x, float y, const char* text) override { SDL_RenderDebugText(renderer, x, y, text); }
+	void doClear() override { SDL_RenderClear(renderer); }
+	void doSetDrawColor(SDL_FColor color) override { SDL_SetRenderDrawColorFloat(renderer, color.r, color.g, color.b, color.a); }
+	void doSetDrawBlendMode(SDL_BlendMode blend) override { SDL_SetRenderDrawBlendMode(renderer, blend); }
+	void doSetTarget(SDL_Texture* texture) override { SDL_SetRenderTarget(renderer, texture); }
+	void doSetClip(const SDL_Rect* clip) override { SDL_SetRenderClipRect(renderer, clip); }
+	void doSetScale(float x, float y) override { SDL_SetRenderScale(renderer, x, y); }
+
+public:
+	explicit SdlRenderBackend(SDL_Renderer* renderer) : RenderBackend(renderer) {}
+	const char* name() const override { return "sdl"; }
+	SDL_Texture* target() const override { return SDL_GetRenderTarget(renderer); }
+	void present() override { SDL_RenderPresent(renderer); }
+	void flush() override { SDL_FlushRenderer(renderer); }
+	void forgetTexture(SDL_Texture*) override {}
+};
+
+//counts what would have been drawn and throws it away, nothing ever reaches the gpu
+//the only thing it keeps is the current target so code that saves and restores it still works
+class NullRenderBackend : public RenderBackend {
+	SDL_Texture* currentTarget;
+
+	void doGeometry(SDL_Texture*, const SDL_Vertex*, int, const int*, int) override {}
+	void doFillRects(const SDL_FRect*, int) override {}
+	void doRects(const SDL_FRect*, int) override {}
+	void doLine(float, float, float, float) override {}
+	void doDebugText(float, float, const char*) override {}
+	void doClear() override {}
+	void doSetDrawColor(SDL_FColor) override {}
+	void doSetDrawBlendMode(SDL_BlendMode) override {}
+	void doSetTarget(SDL_Texture* texture) override { currentTarget = texture; }
+	void doSetClip(const SDL_Rect*) override {}
+	void doSetScale(float, float) override {}
+
+public:
+	explicit NullRenderBackend(SDL_Renderer* renderer) : RenderBackend(renderer), currentTarget(nullptr) {}
+	const char* name() const override { return "null"; }
+	SDL_Texture* target() const override { return currentTarget; }
+	void present() override {}
+	void flush() override {}
+	void forgetTexture(SDL_Texture* texture) override {
+		if (currentTarget == texture) {
+			currentTarget = nullptr;
+		}
+	}
+};
@@ -0,0 +1,154 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <cstdint>
+#include <SDL3/SDL.h>
+#include "SpriteBatch.h"
+
+//what gets drawn in front of what, lower draws first
+enum class RenderLayer : uint8_t {
+	sky, backgroundTiles, levelTiles, decals, characters, bullets, tracers, foregroundTiles, overlay
+};
+
+enum class RenderCommandType : uint8_t {
+	sprite, line, fillRect
+};
+
+//one thing to draw, sprites use the texture src dst and flip, lines go from dst.x,dst.y to dst.w,dst.h
+//for sprites the colour is multiplied into the texture through the vertices so tinting one never touches the texture
+struct RenderCommand {
+	RenderCommandType type;
+	RenderLayer layer;
+	SDL_BlendMode blend;
+	SDL_Texture* texture;
+	SDL_FRect src, dst;
+	bool flipX;
+	SDL_FColor color;
+};
+
+//draws get recorded here during the frame instead of going straight to the renderer
+//then theyre sorted by a 64 bit key and sent out in one go so the same textures and blend modes end up next to each other
+//recording is just pushing onto a vector so a queue can be filled on any thread and appended to the main one after
+//key from the top: 8 bits layer, 2 bits blend, 22 bits texture, 32 bits the order it was recorded in
+class RenderQueue {
+	std::vector<RenderCommand> commands;
+	std::vector<uint64_t> keys, scratch;
+	//textures get a small id the first time theyre seen, kept for good so the order is the same every frame
+	std::unordered_map<const SDL_Texture*, uint32_t> textureIds;
+
+	uint32_t textureId(const SDL_Texture* tex) {
+		if (!tex) {
+			return 0;
+		}
+		return textureIds.try_emplace(tex, static_cast<uint32_t>(textureIds.size() + 1)).first->second;
+	}
+
+	static uint64_t blendBits(SDL_BlendMode blend) {
+		//opaque first then blended, anything else after
+		return blend == SDL_BLENDMODE_NONE ? 0 : blend == SDL_BLENDMODE_BLEND ? 1 : 2;
+	}
+
+	//least significant byte first, each pass is stable so ties keep the order from the passes before
+	//passes where every key has the same byte would just copy so they get skipped
+	void radixSort() {
+		scratch.resize(keys.size());
+		for (int shift = 0; shift < 64; shift += 8) {
+			std::array<size_t, 256> counts{};
+			for (uint64_t key : keys) {
+				counts[(key >> shift) & 0xff]++;
+			}
+			if (counts[(keys[0] >> shift) & 0xff] == keys.size()) {
+				continue;
+			}
+			size_t offset = 0;
+			for (size_t& count : counts) {
+				const size_t n = count;
+				count = offset;
+				offset += n;
+			}
+			for (uint64_t key : keys) {
+				scratch[counts[(key >> shift) & 0xff]++] = key;
+			}
+			keys.swap(scratch);
+		}
+	}
+
+public:
+	//how many commands went out last submit and how many times the draw state had to change
+	int submittedCount;
+	int stateChanges;
+
+	RenderQueue() : submittedCount(0), stateChanges(0) {}
+
+	void sprite(RenderLayer layer, SDL_Texture* tex, const SDL_FRect& src, const SDL_FRect& dst, bool flipX,
+		SDL_FColor color = SDL_FColor{ 1, 1, 1, 1 }) {
+		if (tex) {
+			commands.push_back(RenderCommand{ RenderCommandType::sprite, layer, SDL_BLENDMODE_BLEND, tex, src, dst, flipX, color });
+		}
+	}
+	void line(RenderLayer layer, float x1, float y1, float x2, float y2, SDL_FColor color, SDL_BlendMode blend = SDL_BLENDMODE_BLEND) {
+		commands.push_back(RenderCommand{ RenderCommandType::line, layer, blend, nullptr, SDL_FRect{ 0 },
+			SDL_FRect{ x1, y1, x2, y2 }, false, color });
+	}
+	void fillRect(RenderLayer layer, const SDL_FRect& rect, SDL_FColor color, SDL_BlendMode blend = SDL_BLENDMODE_BLEND) {
+		commands.push_back(RenderCommand{ RenderCommandType::fillRect, layer, blend, nullptr, SDL_FRect{ 0 },
+			rect, false, color });
+	}
+	//moves everything another queue recorded onto the end of this one
+	void append(RenderQueue& other) {
+		commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+		other.commands.clear();
+	}
+	size_t size() const { return commands.size(); }
+
+	//sorts everything recorded, draws it through the batch and empties the queue
+	void submit(RenderBackend& backend, SpriteBatch& batch) {
+		submittedCount = static_cast<int>(commands.size());
+		stateChanges = 0;
+		if (commands.empty()) {
+			return;
+		}
+		keys.clear();
+		for (size_t i = 0; i < commands.size(); i++) {
+			const RenderCommand& cmd = commands[i];
+			keys.push_back(static_cast<uint64_t>(cmd.layer) << 56 | blendBits(cmd.blend) << 54 |
+				static_cast<uint64_t>(textureId(cmd.texture) & 0x3fffff) << 32 | i);
+		}
+		radixSort();
+		//the draw state gets set by the first line or rect since whatever was drawn before could have left anything
+		bool drawStateSet = false;
+		SDL_BlendMode drawBlend = SDL_BLENDMODE_NONE;
+		SDL_FColor drawColor{ 0, 0, 0, 0 };
+		for (uint64_t key : keys) {
+			const RenderCommand& cmd = commands[key & 0xffffffff];
+			if (cmd.type == RenderCommandType::sprite) {
+				batch.draw(cmd.texture, cmd.src, cmd.dst, cmd.flipX, cmd.color);
+				continue;
+			}
+			//lines and rects dont go through the batch so whats queued has to go first
+			batch.flush();
+			if (!drawStateSet || cmd.blend != drawBlend) {
+				backend.setDrawBlendMode(cmd.blend);
+				drawBlend = cmd.blend;
+				stateChanges++;
+			}
+			if (!drawStateSet || cmd.color.r != drawColor.r || cmd.color.g != drawColor.g || cmd.color.b != drawColor.b || cmd.color.a != drawColor.a) {
+				backend.setDrawColor(cmd.color);
+				drawColor = cmd.color;
+				stateChanges++;
+			}
+			drawStateSet = true;
+			if (cmd.type == RenderCommandType::line) {
+				backend.line(cmd.dst.x, cmd.dst.y, cmd.dst.w, cmd.dst.h);
+			}
+			else {
+				backend.fillRect(cmd.dst);
+			}
+		}
+		batch.flush();
+		//the rest of the frame draws straight to the renderer and expects it how it found it
+		backend.setDrawBlendMode(SDL_BLENDMODE_NONE);
+		commands.clear();
+	}
+};
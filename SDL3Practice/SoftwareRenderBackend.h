@@ -0,0 +1,533 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <SDL3/SDL.h>
+#include "RenderBackend.h"
+#include "WorkerPool.h"
+
+//msvc doesnt define __SSE2__ so check its macros too, anything else gets the plain loop
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SOFTWARE_RASTER_SSE2
+#endif
+
+//draws everything on the cpu into a logical sized framebuffer and uploads it to one streaming texture at present
+//draws are recorded as they come in and only rasterised when the target changes or the frame is presented
+//then the target is cut into horizontal bands, one per worker, and every worker goes through the whole list for its rows
+//so no two threads ever touch the same pixel and the result is the same however many workers there are
+//sprites are always axis aligned quads out of the batch so those get a nearest sampled blit blended 4 pixels at a time
+//anything else, ie debug lines, is filled as flat coloured triangles
+//every surface is rgba32 so a pixel is the bytes r g b a in that order whatever the platform
+class SoftwareRenderBackend : public RenderBackend {
+	enum class CommandType : Uint8 {
+		clear, rect, triangle
+	};
+	//the sdl blend modes the game uses, anything else is treated as blend
+	enum class Blend : Uint8 {
+		none, blend, premultiplied
+	};
+	//one thing to rasterise, x0 y0 x1 y1 is the pixels it can touch already cut down to the clip
+	//rects sample source between u0 v0 and u1 v1 in source pixels across dst, flat rects have no source
+	struct Command {
+		CommandType type;
+		Blend blend;
+		const SDL_Surface* source;
+		int x0, y0, x1, y1;
+		SDL_FRect dst;
+		float u0, v0, u1, v1;
+		SDL_FPoint corners[3];
+		//multiplied into each byte of the source, for flat draws the source is white so this is the colour
+		Uint16 tint[4];
+	};
+	//a surface to draw into, render scale and clip are kept per target like sdl does
+	struct Target {
+		SDL_Surface* surface;
+		float scaleX, scaleY;
+		bool clipped;
+		SDL_Rect clip;
+	};
+	struct DebugText {
+		float x, y;
+		std::string text;
+		SDL_FColor color;
+	};
+
+	WorkerPool& workers;
+	SDL_Texture* stream;
+	//the screen is kept under nullptr
+	std::unordered_map<const SDL_Texture*, Target> targets;
+	std::unordered_map<const SDL_Texture*, SDL_Surface*> sources;
+	SDL_Texture* currentTexture;
+	Target* current;
+	std::vector<Command> commands;
+	SDL_FColor drawColor;
+	Blend drawBlend;
+	//debug text uses sdls own font so it gets drawn over the uploaded frame instead
+	std::vector<DebugText> debugTexts;
+	//per worker so bands never share scratch space
+	std::vector<std::vector<Uint32>> rowScratch;
+	std::vector<std::vector<int>> columnScratch;
+
+	static Uint32 div255(Uint32 x) { return (x + 1 + (x >> 8)) >> 8; }
+
+	static Uint16 channel(float c) {
+		return static_cast<Uint16>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255));
+	}
+
+	static Blend blendOf(SDL_BlendMode mode) {
+		return mode == SDL_BLENDMODE_NONE ? Blend::none : mode == SDL_BLENDMODE_BLEND_PREMULTIPLIED ? Blend::premultiplied : Blend::blend;
+	}
+
+	//tints src and either copies it or blends it over dst, same sums as sdls blend modes
+	//blend is rgb = src * a + dst * (1 - a) and a = a + dst a * (1 - a)
+	//premultiplied already has the alpha in the colour so every channel is src + dst * (1 - a), capped at 255
+	static void blendSpanScalar(Uint32* dst, const Uint32* src, int count, const Uint16 tint[4], Blend blend) {
+		for (int i = 0; i < count; i++) {
+			Uint8 s[4], d[4];
+			SDL_memcpy(s, &src[i], 4);
+			SDL_memcpy(d, &dst[i], 4);
+			for (int c = 0; c < 4; c++) {
+				s[c] = static_cast<Uint8>(div255(s[c] * tint[c]));
+			}
+			if (blend == Blend::blend) {
+				const Uint32 a = s[3];
+				for (int c = 0; c < 3; c++) {
+					d[c] = static_cast<Uint8>(div255(s[c] * a + d[c] * (255 - a)));
+				}
+				d[3] = static_cast<Uint8>(div255(s[3] * 255 + d[3] * (255 - a)));
+			}
+			else if (blend == Blend::premultiplied) {
+				const Uint32 a = s[3];
+				for (int c = 0; c < 4; c++) {
+					d[c] = static_cast<Uint8>(std::min<Uint32>(255, s[c] + div255(d[c] * (255 - a))));
+				}
+			}
+			else {
+				SDL_memcpy(d, s, 4);
+			}
+			SDL_memcpy(&dst[i], d, 4);
+		}
+	}
+
+#if defined(SOFTWARE_RASTER_SSE2)
+	static __m128i div255(__m128i x) {
+		return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+	}
+
+	//two pixels widened to 16 bits a channel, the sums never go over 255 * 255 so they fit
+	static __m128i blendHalf(__m128i s, __m128i d, __m128i tint, Blend blend) {
+		s = div255(_mm_mullo_epi16(s, tint));
+		if (blend == Blend::none) {
+			return s;
+		}
+		const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+		if (blend == Blend::premultiplied) {
+			//anything over 255 gets capped when its packed back down to bytes
+			return _mm_adds_epu16(s, div255(_mm_mullo_epi16(d, inverse)));
+		}
+		//the alpha lane takes all of the source alpha instead of source alpha times itself
+		const __m128i srcFactor = _mm_or_si128(_mm_and_si128(alpha, _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1)),
+			_mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+		return div255(_mm_add_epi16(_mm_mullo_epi16(s, srcFactor), _mm_mullo_epi16(d, inverse)));
+	}
+#endif
+
+	//same as blendSpanScalar, 4 pixels at a time where it can
+	static void blendSpan(Uint32* dst, const Uint32* src, int count, const Uint16 tint[4], Blend blend) {
+		int i = 0;
+#if defined(SOFTWARE_RASTER_SSE2)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i tintWide = _mm_set_epi16(tint[3], tint[2], tint[1], tint[0], tint[3], tint[2], tint[1], tint[0]);
+		for (; i + 4 <= count; i += 4) {
+			const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+			const __m128i lo = blendHalf(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), tintWide, blend);
+			const __m128i hi = blendHalf(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), tintWide, blend);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+		}
+#endif
+		blendSpanScalar(dst + i, src + i, count - i, tint, blend);
+	}
+
+	//the part of the current target a draw can touch
+	void bounds(int& x0, int& y0, int& x1, int& y1) const {
+		x0 = 0;
+		y0 = 0;
+		x1 = current->surface->w;
+		y1 = current->surface->h;
+		if (current->clipped) {
+			x0 = std::max(x0, current->clip.x);
+			y0 = std::max(y0, current->clip.y);
+			x1 = std::min(x1, current->clip.x + current->clip.w);
+			y1 = std::min(y1, current->clip.y + current->clip.h);
+		}
+	}
+
+	void tintFrom(Command& cmd, SDL_FColor color) const {
+		cmd.tint[0] = channel(color.r);
+		cmd.tint[1] = channel(color.g);
+		cmd.tint[2] = channel(color.b);
+		cmd.tint[3] = channel(color.a);
+	}
+
+	//dst is in render coordinates, u and v in source pixels
+	void pushRect(const SDL_FRect& dst, const SDL_Surface* source, float u0, float v0, float u1, float v1,
+		SDL_FColor color, Blend blend) {
+		Command cmd{};
+		cmd.type = CommandType::rect;
+		cmd.blend = blend;
+		cmd.source = source;
+		cmd.dst = SDL_FRect{ dst.x * current->scaleX, dst.y * current->scaleY, dst.w * current->scaleX, dst.h * current->scaleY };
+		cmd.u0 = u0;
+		cmd.v0 = v0;
+		cmd.u1 = u1;
+		cmd.v1 = v1;
+		tintFrom(cmd, color);
+		//pixels whose centre is inside the rect
+		bounds(cmd.x0, cmd.y0, cmd.x1, cmd.y1);
+		cmd.x0 = std::max(cmd.x0, static_cast<int>(std::lround(cmd.dst.x)));
+		cmd.y0 = std::max(cmd.y0, static_cast<int>(std::lround(cmd.dst.y)));
+		cmd.x1 = std::min(cmd.x1, static_cast<int>(std::lround(cmd.dst.x + cmd.dst.w)));
+		cmd.y1 = std::min(cmd.y1, static_cast<int>(std::lround(cmd.dst.y + cmd.dst.h)));
+		if (cmd.x0 < cmd.x1 && cmd.y0 < cmd.y1) {
+			commands.push_back(cmd);
+		}
+	}
+
+	void pushTriangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FColor color, Blend blend) {
+		Command cmd{};
+		cmd.type = CommandType::triangle;
+		cmd.blend = blend;
+		cmd.corners[0] = SDL_FPoint{ a.x * current->scaleX, a.y * current->scaleY };
+		cmd.corners[1] = SDL_FPoint{ b.x * current->scaleX, b.y * current->scaleY };
+		cmd.corners[2] = SDL_FPoint{ c.x * current->scaleX, c.y * current->scaleY };
+		tintFrom(cmd, color);
+		bounds(cmd.x0, cmd.y0, cmd.x1, cmd.y1);
+		cmd.x0 = std::max(cmd.x0, static_cast<int>(std::floor(std::min({ cmd.corners[0].x, cmd.corners[1].x, cmd.corners[2].x }))));
+		cmd.y0 = std::max(cmd.y0, static_cast<int>(std::floor(std::min({ cmd.corners[0].y, cmd.corners[1].y, cmd.corners[2].y }))));
+		cmd.x1 = std::min(cmd.x1, static_cast<int>(std::ceil(std::max({ cmd.corners[0].x, cmd.corners[1].x, cmd.corners[2].x }))));
+		cmd.y1 = std::min(cmd.y1, static_cast<int>(std::ceil(std::max({ cmd.corners[0].y, cmd.corners[1].y, cmd.corners[2].y }))));
+		if (cmd.x0 < cmd.x1 && cmd.y0 < cmd.y1) {
+			commands.push_back(cmd);
+		}
+	}
+
+	//rows begin to end of one command, called from every worker with its own band
+	void rasterise(const Command& cmd, SDL_Surface* surface, int begin, int end, int worker) {
+		const int y0 = std::max(cmd.y0, begin), y1 = std::min(cmd.y1, end);
+		if (y0 >= y1) {
+			return;
+		}
+		const int width = cmd.x1 - cmd.x0;
+		std::vector<Uint32>& row = rowScratch[worker];
+		Uint32* pixels = static_cast<Uint32*>(surface->pixels);
+		const int stride = surface->pitch / 4;
+		if (cmd.type == CommandType::triangle) {
+			//edge functions at pixel centres, flipped so inside is positive whichever way round the corners go
+			const SDL_FPoint* p = cmd.corners;
+			const float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[1].y - p[0].y) * (p[2].x - p[0].x);
+			if (area == 0) {
+				return;
+			}
+			const float sign = area > 0 ? 1.0f : -1.0f;
+			//top left rule, a pixel centre right on an edge only counts for a top or left edge
+			//so the diagonal both triangles of a line share is only blended once
+			//each edge is measured from the same end in both triangles so they get exactly opposite values on it
+			struct Edge {
+				SDL_FPoint origin, along;
+				float flip;
+				bool topLeft;
+			} edges[3];
+			for (int e = 0; e < 3; e++) {
+				const SDL_FPoint& a = p[e];
+				const SDL_FPoint& b = p[(e + 1) % 3];
+				const bool swapped = b.x < a.x || (b.x == a.x && b.y < a.y);
+				const SDL_FPoint& from = swapped ? b : a;
+				const SDL_FPoint& to = swapped ? a : b;
+				const float dx = sign * (b.x - a.x), dy = sign * (b.y - a.y);
+				edges[e] = Edge{ from, SDL_FPoint{ to.x - from.x, to.y - from.y }, swapped ? -sign : sign, dy < 0 || (dy == 0 && dx > 0) };
+			}
+			row.assign(width, 0xffffffff);
+			for (int y = y0; y < y1; y++) {
+				int spanStart = -1;
+				for (int x = cmd.x0; x <= cmd.x1; x++) {
+					bool inside = false;
+					if (x < cmd.x1) {
+						const float px = x + 0.5f, py = y + 0.5f;
+						inside = true;
+						for (int e = 0; e < 3 && inside; e++) {
+							const Edge& edge = edges[e];
+							const float w = edge.flip * (edge.along.x * (py - edge.origin.y) - edge.along.y * (px - edge.origin.x));
+							inside = w > 0 || (w == 0 && edge.topLeft);
+						}
+					}
+					if (inside && spanStart == -1) {
+						spanStart = x;
+					}
+					else if (!inside && spanStart != -1) {
+						blendSpan(&pixels[y * stride + spanStart], row.data(), x - spanStart, cmd.tint, cmd.blend);
+						spanStart = -1;
+					}
+				}
+			}
+			return;
+		}
+		if (cmd.type == CommandType::clear || !cmd.source) {
+			row.assign(width, 0xffffffff);
+			for (int y = y0; y < y1; y++) {
+				blendSpan(&pixels[y * stride + cmd.x0], row.data(), width, cmd.tint, cmd.blend);
+			}
+			return;
+		}
+		//nearest sampling, which source column each pixel reads only has to be worked out once
+		//a flipped sprite just has u0 past u1 so the columns come out backwards
+		const SDL_Surface* source = cmd.source;
+		std::vector<int>& columns = columnScratch[worker];
+		columns.resize(width);
+		for (int x = cmd.x0; x < cmd.x1; x++) {
+			const float u = cmd.u0 + (cmd.u1 - cmd.u0) * ((x + 0.5f - cmd.dst.x) / cmd.dst.w);
+			columns[x - cmd.x0] = std::clamp(static_cast<int>(std::floor(u)), 0, source->w - 1);
+		}
+		row.resize(width);
+		const Uint32* sourcePixels = static_cast<const Uint32*>(source->pixels);
+		const int sourceStride = source->pitch / 4;
+		for (int y = y0; y < y1; y++) {
+			const float v = cmd.v0 + (cmd.v1 - cmd.v0) * ((y + 0.5f - cmd.dst.y) / cmd.dst.h);
+			const Uint32* sourceRow = &sourcePixels[std::clamp(static_cast<int>(std::floor(v)), 0, source->h - 1) * sourceStride];
+			for (int i = 0; i < width; i++) {
+				row[i] = sourceRow[columns[i]];
+			}
+			blendSpan(&pixels[y * stride + cmd.x0], row.data(), width, cmd.tint, cmd.blend);
+		}
+	}
+
+	//rasterises everything recorded for the current target
+	void resolve() {
+		if (commands.empty()) {
+			return;
+		}
+		SDL_Surface* surface = current->surface;
+		workers.parallelFor(surface->h, [&](int begin, int end, int worker) {
+			for (const Command& cmd : commands) {
+				rasterise(cmd, surface, begin, end, worker);
+			}
+		});
+		commands.clear();
+	}
+
+	//targets get a surface the first time theyre drawn to, remade if the texture was swapped for another size
+	Target& targetFor(SDL_Texture* texture) {
+		Target& target = targets.try_emplace(texture, Target{ nullptr, 1, 1, false, SDL_Rect{ 0 } }).first->second;
+		if (target.surface && (target.surface->w != texture->w || target.surface->h != texture->h)) {
+			SDL_DestroySurface(target.surface);
+			target.surface = nullptr;
+		}
+		if (!target.surface) {
+			target.surface = SDL_CreateSurface(texture->w, texture->h, SDL_PIXELFORMAT_RGBA32);
+		}
+		return target;
+	}
+
+	//pixels to draw a texture from, a target that was drawn to wins over anything added
+	const SDL_Surface* sourceFor(const SDL_Texture* texture) const {
+		auto target = targets.find(texture);
+		if (texture && target != targets.end()) {
+			return target->second.surface;
+		}
+		auto source = sources.find(texture);
+		return source != sources.end() ? source->second : nullptr;
+	}
+
+	void doGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices, int indexCount) override {
+		const SDL_Surface* source = texture ? sourceFor(texture) : nullptr;
+		if (texture && !source) {
+			return;
+		}
+		SDL_BlendMode textureBlend = SDL_BLENDMODE_BLEND;
+		if (texture) {
+			SDL_GetTextureBlendMode(texture, &textureBlend);
+		}
+		const Blend blend = blendOf(textureBlend);
+		const int count = indices ? indexCount : vertexCount;
+		auto vertex = [&](int i) -> const SDL_Vertex& { return vertices[indices ? indices[i] : i]; };
+		for (int i = 0; i + 3 <= count;) {
+			//the batch writes every quad as corners 0 1 2 0 2 3 going round from the top left
+			if (i + 6 <= count) {
+				const SDL_Vertex& a = vertex(i);
+				const SDL_Vertex& b = vertex(i + 1);
+				const SDL_Vertex& c = vertex(i + 2);
+				const SDL_Vertex& d = vertex(i + 5);
+				const bool quad = &vertex(i + 3) == &a && &vertex(i + 4) == &c;
+				if (quad && a.position.y == b.position.y && b.position.x == c.position.x &&
+					c.position.y == d.position.y && d.position.x == a.position.x) {
+					const SDL_Vertex& left = a.position.x <= b.position.x ? a : b;
+					const SDL_Vertex& right = a.position.x <= b.position.x ? b : a;
+					const SDL_Vertex& top = a.position.y <= d.position.y ? a : d;
+					const SDL_Vertex& bottom = a.position.y <= d.position.y ? d : a;
+					const SDL_FRect dst{ left.position.x, top.position.y, right.position.x - left.position.x, bottom.position.y - top.position.y };
+					if (source) {
+						pushRect(dst, source, left.tex_coord.x * source->w, top.tex_coord.y * source->h,
+							right.tex_coord.x * source->w, bottom.tex_coord.y * source->h, a.color, blend);
+					}
+					else {
+						pushRect(dst, nullptr, 0, 0, 0, 0, a.color, blend);
+					}
+					i += 6;
+					continue;
+				}
+			}
+			//nothing in the game draws textured triangles that arent quads so these just get the vertex colour
+			pushTriangle(vertex(i).position, vertex(i + 1).position, vertex(i + 2).position, vertex(i).color, blend);
+			i += 3;
+		}
+	}
+	void doFillRects(const SDL_FRect* rects, int count) override {
+		for (int i = 0; i < count; i++) {
+			pushRect(rects[i], nullptr, 0, 0, 0, 0, drawColor, drawBlend);
+		}
+	}
+	//outlines are four one pixel fills, the sides go between the top and bottom so corners arent blended twice
+	void doRects(const SDL_FRect* rects, int count) override {
+		for (int i = 0; i < count; i++) {
+			const SDL_FRect& r = rects[i];
+			pushRect(SDL_FRect{ r.x, r.y, r.w, 1 }, nullptr, 0, 0, 0, 0, drawColor, drawBlend);
+			if (r.h > 1) {
+				pushRect(SDL_FRect{ r.x, r.y + r.h - 1, r.w, 1 }, nullptr, 0, 0, 0, 0, drawColor, drawBlend);
+			}
+			if (r.h > 2) {
+				pushRect(SDL_FRect{ r.x, r.y + 1, 1, r.h - 2 }, nullptr, 0, 0, 0, 0, drawColor, drawBlend);
+				pushRect(SDL_FRect{ r.x + r.w - 1, r.y + 1, 1, r.h - 2 }, nullptr, 0, 0, 0, 0, drawColor, drawBlend);
+			}
+		}
+	}
+	//one pixel wide quad along the line the same way the debug overlay does it
+	void doLine(float x1, float y1, float x2, float y2) override {
+		const float dx = x2 - x1, dy = y2 - y1;
+		const float len = std::sqrt(dx * dx + dy * dy);
+		if (len == 0) {
+			return;
+		}
+		const float nx = -dy / len * 0.5f, ny = dx / len * 0.5f;
+		const SDL_FPoint a{ x1 + nx, y1 + ny }, b{ x2 + nx, y2 + ny }, c{ x2 - nx, y2 - ny }, d{ x1 - nx, y1 - ny };
+		pushTriangle(a, b, c, drawColor, drawBlend);
+		pushTriangle(a, c, d, drawColor, drawBlend);
+	}
+	//wherever it was drawn it ends up at the same place on screen, ie the reduced scale target gets stretched back out
+	void doDebugText(float x, float y, const char* text) override {
+		debugTexts.push_back(DebugText{ x, y, text, drawColor });
+	}
+	//clear ignores the clip and blending like it does in sdl
+	void doClear() override {
+		Command cmd{};
+		cmd.type = CommandType::clear;
+		cmd.blend = Blend::none;
+		cmd.x1 = current->surface->w;
+		cmd.y1 = current->surface->h;
+		tintFrom(cmd, drawColor);
+		commands.push_back(cmd);
+	}
+	void doSetDrawColor(SDL_FColor color) override { drawColor = color; }
+	void doSetDrawBlendMode(SDL_BlendMode blend) override { drawBlend = blendOf(blend); }
+	void doSetTarget(SDL_Texture* texture) override {
+		if (texture == currentTexture) {
+			return;
+		}
+		//whatever was drawn has to be in the pixels before the target can be drawn from
+		resolve();
+		currentTexture = texture;
+		current = texture ? &targetFor(texture) : &targets[nullptr];
+	}
+	void doSetClip(const SDL_Rect* clip) override {
+		current->clipped = clip != nullptr;
+		if (clip) {
+			current->clip = SDL_Rect{
+				.x = static_cast<int>(std::lround(clip->x * current->scaleX)),
+				.y = static_cast<int>(std::lround(clip->y * current->scaleY)),
+				.w = static_cast<int>(std::lround(clip->w * current->scaleX)),
+				.h = static_cast<int>(std::lround(clip->h * current->scaleY))
+			};
+		}
+	}
+	void doSetScale(float x, float y) override {
+		current->scaleX = x;
+		current->scaleY = y;
+	}
+
+public:
+	SoftwareRenderBackend(SDL_Renderer* renderer, int width, int height, WorkerPool& workers)
+		: RenderBackend(renderer), workers(workers), currentTexture(nullptr), drawColor{ 0, 0, 0, 1 }, drawBlend(Blend::none),
+		rowScratch(workers.size()), columnScratch(workers.size()) {
+		targets[nullptr] = Target{ SDL_CreateSurface(width, height, SDL_PIXELFORMAT_RGBA32), 1, 1, false, SDL_Rect{ 0 } };
+		current = &targets[nullptr];
+		stream = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+		SDL_SetTextureScaleMode(stream, SDL_SCALEMODE_NEAREST);
+		SDL_SetTextureBlendMode(stream, SDL_BLENDMODE_NONE);
+	}
+	~SoftwareRenderBackend() {
+		for (auto& [texture, target] : targets) {
+			SDL_DestroySurface(target.surface);
+		}
+		for (auto& [texture, surface] : sources) {
+			SDL_DestroySurface(surface);
+		}
+		SDL_DestroyTexture(stream);
+	}
+
+	//keeps a copy of the pixels a texture was made from, a texture without any wont draw
+	void addSource(const SDL_Texture* texture, SDL_Surface* pixels) {
+		if (!texture || !pixels) {
+			return;
+		}
+		SDL_Surface* copy = SDL_ConvertSurface(pixels, SDL_PIXELFORMAT_RGBA32);
+		SDL_Surface*& slot = sources[texture];
+		SDL_DestroySurface(slot);
+		slot = copy;
+	}
+
+	const char* name() const override { return "software"; }
+	SDL_Texture* target() const override { return currentTexture; }
+	void flush() override { resolve(); }
+	//drops the surface kept for a target thats going away, otherwise every chunk ever baked would stay in memory
+	//and a new texture that happened to get the same address would start out with the old ones pixels
+	void forgetTexture(SDL_Texture* texture) override {
+		if (!texture) {
+			return;
+		}
+		//recorded draws can still be reading from it or writing into it
+		resolve();
+		if (currentTexture == texture) {
+			currentTexture = nullptr;
+			current = &targets[nullptr];
+		}
+		auto target = targets.find(texture);
+		if (target != targets.end()) {
+			SDL_DestroySurface(target->second.surface);
+			targets.erase(target);
+		}
+		auto source = sources.find(texture);
+		if (source != sources.end()) {
+			SDL_DestroySurface(source->second);
+			sources.erase(source);
+		}
+	}
+	//the only time anything reaches the real renderer, one upload and one copy of the whole frame
+	void present() override {
+		setTarget(nullptr);
+		resolve();
+		SDL_Surface* frame = targets[nullptr].surface;
+		SDL_UpdateTexture(stream, nullptr, frame->pixels, frame->pitch);
+		SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+		SDL_RenderClear(renderer);
+		SDL_RenderTexture(renderer, stream, nullptr, nullptr);
+		for (const DebugText& text : debugTexts) {
+			SDL_SetRenderDrawColorFloat(renderer, text.color.r, text.color.g, text.color.b, text.color.a);
+			SDL_RenderDebugText(renderer, text.x, text.y, text.text.c_str());
+		}
+		debugTexts.clear();
+		SDL_RenderPresent(renderer);
+	}
+};
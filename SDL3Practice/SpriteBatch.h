@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <initializer_list>
+#include <SDL3/SDL.h>
+#include "RenderBackend.h"
+
+//collects textured quads and hands them to SDL_RenderGeometry in one go instead of one render call per sprite
+//everything queued has to share a texture, drawing with a different one flushes whats there first
+//so with the atlas most of a frame ends up in a couple of calls
+class SpriteBatch {
+	RenderBackend* backend;
+	SDL_Texture* texture;
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;
+
+public:
+	//how many quads and how many geometry calls since the last beginFrame
+	int spriteCount;
+	int flushCount;
+
+	explicit SpriteBatch(RenderBackend* backend = nullptr)
+		: backend(backend), texture(nullptr), spriteCount(0), flushCount(0) {}
+
+	void beginFrame() {
+		spriteCount = flushCount = 0;
+	}
+
+	//queues src from tex stretched over dst, flipping swaps the u coordinates instead of needing a separate call
+	void draw(SDL_Texture* tex, const SDL_FRect& src, const SDL_FRect& dst, bool flipX,
+		SDL_FColor color = SDL_FColor{ 1, 1, 1, 1 }) {
+		if (!tex) {
+			return;
+		}
+		if (tex != texture) {
+			flush();
+			texture = tex;
+		}
+		const float texW = static_cast<float>(tex->w), texH = static_cast<float>(tex->h);
+		float u0 = src.x / texW, u1 = (src.x + src.w) / texW;
+		const float v0 = src.y / texH, v1 = (src.y + src.h) / texH;
+		if (flipX) {
+			std::swap(u0, u1);
+		}
+		const int first = static_cast<int>(vertices.size());
+		vertices.push_back(SDL_Vertex{ { dst.x, dst.y }, color, { u0, v0 } });
+		vertices.push_back(SDL_Vertex{ { dst.x + dst.w, dst.y }, color, { u1, v0 } });
+		vertices.push_back(SDL_Vertex{ { dst.x + dst.w, dst.y + dst.h }, color, { u1, v1 } });
+		vertices.push_back(SDL_Vertex{ { dst.x, dst.y + dst.h }, color, { u0, v1 } });
+		for (int corner : { 0, 1, 2, 0, 2, 3 }) {
+			indices.push_back(first + corner);
+		}
+		spriteCount++;
+	}
+
+	//draws whatever is queued, has to be called before drawing anything else straight to the renderer
+	void flush() {
+		if (!indices.empty()) {
+			backend->geometry(texture, vertices.data(), static_cast<int>(vertices.size()),
+				indices.data(), static_cast<int>(indices.size()));
+			flushCount++;
+		}
+		vertices.clear();
+		indices.clear();
+	}
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <SDL3/SDL.h>
+
+//how far along a move from 0 to 1 a moving box first touches a still one
+//returns something over 1 if it never touches during the move or if they already overlap at the start,
+//the normal discrete check deals with boxes that start out overlapping
+inline float sweptAabb(const SDL_FRect& a, float dx, float dy, const SDL_FRect& b) {
+	const float inf = std::numeric_limits<float>::infinity();
+	//works out when the box enters and leaves the other box on one axis
+	const auto axis = [inf](float aMin, float aMax, float bMin, float bMax, float d, float& entry, float& exit) {
+		if (d > 0) {
+			entry = (bMin - aMax) / d;
+			exit = (bMax - aMin) / d;
+		}
+		else if (d < 0) {
+			entry = (bMax - aMin) / d;
+			exit = (bMin - aMax) / d;
+		}
+		else {
+			//not moving on this axis so its either overlapping the whole time or never
+			const bool overlapping = aMax >= bMin && aMin <= bMax;
+			entry = overlapping ? -inf : inf;
+			exit = overlapping ? inf : -inf;
+		}
+	};
+	float xEntry, xExit, yEntry, yExit;
+	axis(a.x, a.x + a.w, b.x, b.x + b.w, dx, xEntry, xExit);
+	axis(a.y, a.y + a.h, b.y, b.y + b.h, dy, yEntry, yExit);
+	const float entry = std::max(xEntry, yEntry);
+	const float exit = std::min(xExit, yExit);
+	if (entry > exit || entry < 0 || entry > 1) {
+		return inf;
+	}
+	return entry;
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <climits>
+#include <SDL3/SDL.h>
+
+//where a sprite sheet ended up, which page and the rect it covers on that page
+struct AtlasRegion {
+	int page;
+	SDL_FRect rect;
+};
+
+//packs lots of little images onto a few big pages at load time so drawing them doesnt keep swapping textures
+//images are looked up by the texture they were loaded as so the rest of the game can keep passing those around
+//packing is skyline bottom left, each page tracks the top edge of whats been placed and new images go in the lowest gap
+class TextureAtlas {
+	struct SkylineNode {
+		int x, y, w;
+	};
+	struct Pending {
+		SDL_Texture* key;
+		SDL_Surface* surface;
+	};
+
+	int pageSize;
+	//empty pixels left around every image, filled with its edge pixels so filtering never picks up a neighbour
+	int gutter;
+	std::vector<std::vector<SkylineNode>> skylines;
+	std::vector<Pending> pending;
+	std::unordered_map<const SDL_Texture*, AtlasRegion> regions;
+
+	//lowest spot along one skyline where a w by h image fits, returns the node index it starts on or -1
+	int findSpot(const std::vector<SkylineNode>& skyline, int w, int h, int& bestX, int& bestY) const {
+		int best = -1;
+		int bestWidth = INT_MAX;
+		bestY = INT_MAX;
+		for (int i = 0; i < static_cast<int>(skyline.size()); i++) {
+			const int x = skyline[i].x;
+			if (x + w > pageSize) {
+				break;
+			}
+			//the image sits on the highest node it spans
+			int y = 0;
+			int remaining = w;
+			for (int j = i; remaining > 0; j++) {
+				y = std::max(y, skyline[j].y);
+				remaining -= skyline[j].w;
+			}
+			if (y + h > pageSize) {
+				continue;
+			}
+			//prefer the lowest spot then the snuggest one
+			if (y < bestY || (y == bestY && skyline[i].w < bestWidth)) {
+				best = i;
+				bestX = x;
+				bestY = y;
+				bestWidth = skyline[i].w;
+			}
+		}
+		return best;
+	}
+
+	//raises the skyline under a newly placed image and merges any flat runs left behind
+	void place(std::vector<SkylineNode>& skyline, int index, int x, int y, int w, int h) {
+		skyline.insert(skyline.begin() + index, SkylineNode{ x, y + h, w });
+		for (int i = index + 1; i < static_cast<int>(skyline.size());) {
+			const int overlap = x + w - skyline[i].x;
+			if (overlap <= 0) {
+				break;
+			}
+			if (overlap >= skyline[i].w) {
+				skyline.erase(skyline.begin() + i);
+			}
+			else {
+				skyline[i].x += overlap;
+				skyline[i].w -= overlap;
+				break;
+			}
+		}
+		for (int i = 0; i + 1 < static_cast<int>(skyline.size());) {
+			if (skyline[i].y == skyline[i + 1].y) {
+				skyline[i].w += skyline[i + 1].w;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+
+	//copies the image onto the page then smears its outer rows and columns into the gutter
+	void blit(SDL_Surface* surface, SDL_Surface* page, int x, int y) {
+		const int w = surface->w, h = surface->h;
+		SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+		SDL_Rect dst{ x, y, w, h };
+		SDL_BlitSurface(surface, nullptr, page, &dst);
+		//both are rgba32 so a pixel is one Uint32
+		Uint32* pixels = static_cast<Uint32*>(page->pixels);
+		const int stride = page->pitch / 4;
+		for (int row = y; row < y + h; row++) {
+			for (int g = 1; g <= gutter; g++) {
+				pixels[row * stride + x - g] = pixels[row * stride + x];
+				pixels[row * stride + x + w - 1 + g] = pixels[row * stride + x + w - 1];
+			}
+		}
+		//the rows get copied with the side gutters already filled so the corners get filled in too
+		const size_t rowBytes = (w + gutter * 2) * sizeof(Uint32);
+		for (int g = 1; g <= gutter; g++) {
+			SDL_memcpy(&pixels[(y - g) * stride + x - gutter], &pixels[y * stride + x - gutter], rowBytes);
+			SDL_memcpy(&pixels[(y + h - 1 + g) * stride + x - gutter], &pixels[(y + h - 1) * stride + x - gutter], rowBytes);
+		}
+	}
+
+public:
+	std::vector<SDL_Texture*> pages;
+	//the pages as pixels too for anything that wants to read them on the cpu
+	std::vector<SDL_Surface*> pageSurfaces;
+
+	explicit TextureAtlas(int pageSize = 1024, int gutter = 1) : pageSize(pageSize), gutter(gutter) {}
+	~TextureAtlas() { destroy(); }
+	TextureAtlas(const TextureAtlas&) = delete;
+	TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+	//queues an image to be packed, the atlas takes the surface and frees it once built
+	void add(SDL_Texture* key, SDL_Surface* surface) {
+		if (key && surface) {
+			pending.push_back(Pending{ key, surface });
+		}
+		else if (surface) {
+			SDL_DestroySurface(surface);
+		}
+	}
+
+	//packs everything queued onto as many pages as it takes and uploads them
+	//anything too big for a page is left out and keeps drawing from its own texture
+	void build(SDL_Renderer* renderer) {
+		//tallest first packs a lot tighter with a skyline
+		std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+			return a.surface->h != b.surface->h ? a.surface->h > b.surface->h : a.surface->w > b.surface->w;
+		});
+		for (const Pending& item : pending) {
+			SDL_Surface* surface = SDL_ConvertSurface(item.surface, SDL_PIXELFORMAT_RGBA32);
+			SDL_DestroySurface(item.surface);
+			if (!surface) {
+				continue;
+			}
+			const int w = surface->w + gutter * 2, h = surface->h + gutter * 2;
+			int page = -1, x = 0, y = 0;
+			for (int p = 0; p < static_cast<int>(skylines.size()) && page == -1; p++) {
+				const int index = findSpot(skylines[p], w, h, x, y);
+				if (index != -1) {
+					place(skylines[p], index, x, y, w, h);
+					page = p;
+				}
+			}
+			if (page == -1 && w <= pageSize && h <= pageSize) {
+				//no new page just leaves the image unpacked on its own texture
+				SDL_Surface* pageSurface = SDL_CreateSurface(pageSize, pageSize, SDL_PIXELFORMAT_RGBA32);
+				if (pageSurface) {
+					skylines.push_back({ SkylineNode{ 0, 0, pageSize } });
+					pageSurfaces.push_back(pageSurface);
+					page = static_cast<int>(skylines.size()) - 1;
+					const int index = findSpot(skylines[page], w, h, x, y);
+					place(skylines[page], index, x, y, w, h);
+				}
+			}
+			if (page != -1) {
+				blit(surface, pageSurfaces[page], x + gutter, y + gutter);
+				regions[item.key] = AtlasRegion{
+					page,
+					SDL_FRect{
+						.x = static_cast<float>(x + gutter),
+						.y = static_cast<float>(y + gutter),
+						.w = static_cast<float>(surface->w),
+						.h = static_cast<float>(surface->h)
+					}
+				};
+			}
+			SDL_DestroySurface(surface);
+		}
+		pending.clear();
+		for (SDL_Surface* surface : pageSurfaces) {
+			SDL_Texture* tex = SDL_CreateTextureFromSurface(renderer, surface);
+			SDL_SetTextureScaleMode(tex, SDL_SCALEMODE_NEAREST);
+			pages.push_back(tex);
+		}
+		//a page that didnt upload gives its images back so they keep drawing from their own textures
+		std::erase_if(regions, [this](const auto& entry) { return !pages[entry.second.page]; });
+	}
+
+	//packed images are looked up by key only, the texture behind a key may already be gone so never draw from it
+	const AtlasRegion* find(const SDL_Texture* key) const {
+		auto it = regions.find(key);
+		return it != regions.end() ? &it->second : nullptr;
+	}
+
+	//source rect of one frame of a horizontal sprite sheet on its page, frames are frameW wide starting from the left
+	SDL_FRect frameRect(const AtlasRegion& region, int frame, float frameW, float frameH) const {
+		return SDL_FRect{ region.rect.x + frame * frameW, region.rect.y, frameW, frameH };
+	}
+
+	void destroy() {
+		for (SDL_Texture* tex : pages) {
+			SDL_DestroyTexture(tex);
+		}
+		for (SDL_Surface* surface : pageSurfaces) {
+			SDL_DestroySurface(surface);
+		}
+		for (const Pending& item : pending) {
+			SDL_DestroySurface(item.surface);
+		}
+		pages.clear();
+		pageSurfaces.clear();
+		pending.clear();
+		regions.clear();
+		skylines.clear();
+	}
+};
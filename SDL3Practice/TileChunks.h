@@ -0,0 +1,127 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <SDL3/SDL.h>
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+
+//a tile layer that never changes cut into strips a fixed number of columns wide
+//each strip gets drawn into its own texture the first time it comes on screen and after that its one quad a frame
+//strips that havent been on screen for a while get thrown away once the layer goes over its memory budget
+class TileChunkCache {
+	struct Chunk {
+		SDL_Texture* texture;
+		uint64_t lastUsed;
+		bool dirty;
+	};
+
+	int rows, cols, chunkCols;
+	float originX, originY, tileSize;
+	size_t budgetBytes;
+	std::vector<Chunk> chunks;
+	uint64_t frame;
+
+	size_t chunkBytes() const {
+		return static_cast<size_t>(chunkCols * tileSize) * static_cast<size_t>(rows * tileSize) * 4;
+	}
+
+	//drops the least recently drawn chunks that arent on screen until the layer fits its budget again
+	void evict(RenderBackend& backend) {
+		while (bakedCount() * chunkBytes() > budgetBytes) {
+			Chunk* oldest = nullptr;
+			for (Chunk& chunk : chunks) {
+				if (chunk.texture && chunk.lastUsed != frame && (!oldest || chunk.lastUsed < oldest->lastUsed)) {
+					oldest = &chunk;
+				}
+			}
+			if (!oldest) {
+				return;
+			}
+			backend.forgetTexture(oldest->texture);
+			SDL_DestroyTexture(oldest->texture);
+			oldest->texture = nullptr;
+			oldest->dirty = true;
+		}
+	}
+
+public:
+	//how many chunks were baked this frame
+	int bakesThisFrame;
+
+	TileChunkCache() : rows(0), cols(0), chunkCols(1), originX(0), originY(0), tileSize(1), budgetBytes(0), frame(0), bakesThisFrame(0) {}
+	TileChunkCache(int rows, int cols, float originX, float originY, float tileSize, int chunkCols, size_t budgetBytes)
+		: rows(rows), cols(cols), chunkCols(chunkCols), originX(originX), originY(originY), tileSize(tileSize),
+		budgetBytes(budgetBytes), chunks((cols + chunkCols - 1) / chunkCols, Chunk{ nullptr, 0, true }), frame(0), bakesThisFrame(0) {}
+
+	int bakedCount() const {
+		return static_cast<int>(std::count_if(chunks.begin(), chunks.end(), [](const Chunk& chunk) { return chunk.texture != nullptr; }));
+	}
+
+	//queues every chunk overlapping the viewport on the given layer, baking any that are missing or dirty first
+	//bake gets the columns to draw and where the chunk sits in the world, it should draw through the batch
+	//baking happens straight away so the chunk is ready by the time the queue is submitted
+	void draw(RenderBackend& backend, SpriteBatch& batch, RenderQueue& queue, RenderLayer layer, const SDL_FRect& viewport,
+		const std::function<void(int c0, int c1, float chunkX, float chunkY)>& bake) {
+		frame++;
+		bakesThisFrame = 0;
+		const float chunkW = chunkCols * tileSize, chunkH = rows * tileSize;
+		const int first = std::max(0, static_cast<int>(std::floor((viewport.x - originX) / chunkW)));
+		const int last = std::min(static_cast<int>(chunks.size()) - 1,
+			static_cast<int>(std::floor((viewport.x + viewport.w - originX) / chunkW)));
+		for (int i = first; i <= last; i++) {
+			Chunk& chunk = chunks[i];
+			const float chunkX = originX + i * chunkW;
+			if (chunk.dirty) {
+				if (!chunk.texture) {
+					chunk.texture = SDL_CreateTexture(backend.renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+						static_cast<int>(chunkW), static_cast<int>(chunkH));
+					//no texture means the chunk stays dirty and is left out this frame, baking it would go to the screen
+					if (!chunk.texture) {
+						continue;
+					}
+					SDL_SetTextureScaleMode(chunk.texture, SDL_SCALEMODE_NEAREST);
+					SDL_SetTextureBlendMode(chunk.texture, SDL_BLENDMODE_BLEND);
+				}
+				//anything queued belongs to the screen so it has to go out before switching targets
+				batch.flush();
+				SDL_Texture* previous = backend.target();
+				backend.setTarget(chunk.texture);
+				backend.setDrawColor(0, 0, 0, 0);
+				backend.clear();
+				bake(i * chunkCols, std::min(cols, (i + 1) * chunkCols) - 1, chunkX, originY);
+				batch.flush();
+				backend.setTarget(previous);
+				chunk.dirty = false;
+				bakesThisFrame++;
+			}
+			chunk.lastUsed = frame;
+			queue.sprite(layer, chunk.texture, SDL_FRect{ 0, 0, chunkW, chunkH },
+				SDL_FRect{ chunkX - viewport.x, originY - viewport.y, chunkW, chunkH }, false);
+		}
+		evict(backend);
+	}
+
+	//the chunk holding this column gets baked again next time its drawn
+	void markDirty(int col) {
+		if (col >= 0 && col < cols) {
+			chunks[col / chunkCols].dirty = true;
+		}
+	}
+	//render target contents can get lost, ie when the device is reset, so everything has to be baked again
+	void invalidate() {
+		for (Chunk& chunk : chunks) {
+			chunk.dirty = true;
+		}
+	}
+	void destroy(RenderBackend& backend) {
+		for (Chunk& chunk : chunks) {
+			backend.forgetTexture(chunk.texture);
+			SDL_DestroyTexture(chunk.texture);
+			chunk.texture = nullptr;
+			chunk.dirty = true;
+		}
+	}
+};
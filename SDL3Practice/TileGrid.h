@@ -0,0 +1,99 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <SDL3/SDL.h>
+
+//a dense grid laid out on the tile size so we can find what is at a position without looping through every tile
+//each cell holds an index into some other list, -1 means the cell is empty
+struct TileGrid {
+	int rows, cols;
+	float originX, originY, tileSize;
+	std::vector<int> cells;
+
+	TileGrid() : rows(0), cols(0), originX(0), originY(0), tileSize(1) {}
+	TileGrid(int rows, int cols, float originX, float originY, float tileSize)
+		: rows(rows), cols(cols), originX(originX), originY(originY), tileSize(tileSize), cells(rows * cols, -1) {}
+
+	void set(int r, int c, int value) { cells[r * cols + c] = value; }
+	int get(int r, int c) const {
+		if (r < 0 || r >= rows || c < 0 || c >= cols) {
+			return -1;
+		}
+		return cells[r * cols + c];
+	}
+
+	//row and column of the cell under a point, returns false if the point is off the grid
+	bool cellAt(float x, float y, int& r, int& c) const {
+		c = static_cast<int>(std::floor((x - originX) / tileSize));
+		r = static_cast<int>(std::floor((y - originY) / tileSize));
+		return r >= 0 && r < rows && c >= 0 && c < cols;
+	}
+
+	//world space rect covered by one cell
+	SDL_FRect cellRect(int r, int c) const {
+		return SDL_FRect{ originX + c * tileSize, originY + r * tileSize, tileSize, tileSize };
+	}
+
+	//works out the rows and columns a rect touches, edges count as touching same as SDL_GetRectIntersectionFloat
+	//padding grows the range by that many cells on every side, returns false if the rect misses the grid entirely
+	bool cellRange(const SDL_FRect& rect, int& r0, int& c0, int& r1, int& c1, int padding = 0) const {
+		c0 = static_cast<int>(std::floor((rect.x - originX) / tileSize)) - padding;
+		c1 = static_cast<int>(std::floor((rect.x + rect.w - originX) / tileSize)) + padding;
+		r0 = static_cast<int>(std::floor((rect.y - originY) / tileSize)) - padding;
+		r1 = static_cast<int>(std::floor((rect.y + rect.h - originY) / tileSize)) + padding;
+		if (c1 < 0 || r1 < 0 || c0 >= cols || r0 >= rows) {
+			return false;
+		}
+		c0 = std::max(c0, 0);
+		r0 = std::max(r0, 0);
+		c1 = std::min(c1, cols - 1);
+		r1 = std::min(r1, rows - 1);
+		return true;
+	}
+
+	//when a value covers a block of cells this is only true at the first cell of the block inside the range
+	//so looping over a range can handle each value once
+	bool firstInRange(int r, int c, int r0, int c0) const {
+		const int value = get(r, c);
+		return (c == c0 || get(r, c - 1) != value) && (r == r0 || get(r - 1, c) != value);
+	}
+};
+
+//greedily merges solid cells into as few rectangles as it can, results are in cells not pixels
+//grows each rectangle as wide as it can along the row first then pulls it down while the whole span below is solid
+inline std::vector<SDL_Rect> mergeSolidCells(const std::vector<bool>& solid, int rows, int cols) {
+	std::vector<SDL_Rect> rects;
+	std::vector<bool> used(solid.size(), false);
+	const auto isFree = [&](int r, int c) {
+		return solid[r * cols + c] && !used[r * cols + c];
+	};
+	for (int r = 0; r < rows; r++) {
+		for (int c = 0; c < cols; c++) {
+			if (!isFree(r, c)) {
+				continue;
+			}
+			int w = 1;
+			while (c + w < cols && isFree(r, c + w)) {
+				w++;
+			}
+			int h = 1;
+			bool rowFits = true;
+			while (r + h < rows && rowFits) {
+				for (int i = c; i < c + w && rowFits; i++) {
+					rowFits = isFree(r + h, i);
+				}
+				if (rowFits) {
+					h++;
+				}
+			}
+			for (int y = r; y < r + h; y++) {
+				for (int x = c; x < c + w; x++) {
+					used[y * cols + x] = true;
+				}
+			}
+			rects.push_back(SDL_Rect{ c, r, w, h });
+		}
+	}
+	return rects;
+}
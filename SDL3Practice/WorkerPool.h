@@ -0,0 +1,85 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+
+//a handful of threads that stay alive for the whole game and get handed a job at a time
+//the thread calling run works on the job too so a pool with no extra threads just runs everything inline
+class WorkerPool {
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable jobReady, jobFinished;
+	std::function<void(int)> job;
+	int generation;
+	int busy;
+	bool quitting;
+
+	void workerLoop(int worker) {
+		int seenGeneration = 0;
+		while (true) {
+			std::unique_lock<std::mutex> lock(mutex);
+			jobReady.wait(lock, [&] { return quitting || generation != seenGeneration; });
+			if (quitting) {
+				return;
+			}
+			seenGeneration = generation;
+			lock.unlock();
+			job(worker);
+			lock.lock();
+			if (--busy == 0) {
+				jobFinished.notify_one();
+			}
+		}
+	}
+
+public:
+	explicit WorkerPool(int extraThreads) : generation(0), busy(0), quitting(false) {
+		for (int i = 0; i < extraThreads; i++) {
+			//worker 0 is whoever calls run so the threads start at 1
+			threads.emplace_back(&WorkerPool::workerLoop, this, i + 1);
+		}
+	}
+	~WorkerPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quitting = true;
+		}
+		jobReady.notify_all();
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	//how many workers a job gets split between including the calling thread
+	int size() const { return static_cast<int>(threads.size()) + 1; }
+
+	//runs fn(worker) once on every worker and waits for all of them
+	void run(const std::function<void(int)>& fn) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			job = fn;
+			busy = static_cast<int>(threads.size());
+			generation++;
+		}
+		jobReady.notify_all();
+		fn(0);
+		std::unique_lock<std::mutex> lock(mutex);
+		jobFinished.wait(lock, [&] { return busy == 0; });
+	}
+
+	//splits 0 to count into one block per worker in order so worker w always gets the w'th block
+	void parallelFor(int count, const std::function<void(int begin, int end, int worker)>& fn) {
+		const int workers = size();
+		const int blockSize = (count + workers - 1) / workers;
+		run([&](int worker) {
+			const int begin = std::min(count, worker * blockSize);
+			const int end = std::min(count, begin + blockSize);
+			fn(begin, end, worker);
+		});
+	}
+};